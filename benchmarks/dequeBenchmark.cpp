@@ -0,0 +1,248 @@
+#include "dequeHeader.hpp"
+#include "parallelDequeHeader.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <new>
+#include <random>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+/**************************************************************************************************
+ * Benchmark suite comparing Deque with std::deque.
+ * 
+ * Every workload runs for several element sizes and block sizes and reports the time per
+ * operation, the number and total size of heap allocations, and the resident set size of
+ * the process while the container is still alive. The par_* workloads run the parallel
+ * algorithms and are reported for Deque only.
+ * 
+ * Usage: dequeBenchmark [elements]
+ **************************************************************************************************/
+
+static std::atomic<size_t> allocationCount = 0;
+static std::atomic<size_t> allocationBytes = 0;
+
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    size_t align = static_cast<size_t>(alignment);
+    if (void* p = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+template <size_t BYTES>
+struct Payload {
+    std::array<unsigned char, BYTES> bytes{};
+    Payload() = default;
+    explicit Payload(size_t n) { bytes[0] = static_cast<unsigned char>(n); }
+    size_t key() const { return bytes[0]; }
+};
+
+template <>
+struct Payload<4> {
+    unsigned value = 0;
+    Payload() = default;
+    explicit Payload(size_t n) : value(static_cast<unsigned>(n)) {}
+    size_t key() const { return value; }
+};
+
+static volatile size_t sink = 0;
+
+/**************************************************************************************************
+ * @brief Returns the resident set size of the process in bytes (Linux), or 0 if unknown.
+ **************************************************************************************************/
+static size_t residentBytes() {
+    std::ifstream statm("/proc/self/statm");
+    size_t pages = 0, resident = 0;
+    if (!(statm >> pages >> resident)) {
+        return 0;
+    }
+    return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+/**************************************************************************************************
+ * @brief Times one workload and prints a result row.
+ * 
+ * The workload receives a fresh container and performs `ops` operations; the container is
+ * kept alive until the RSS sample so its footprint is included.
+ **************************************************************************************************/
+template <typename Container, typename Workload>
+void measure(const char* workload, const char* container, size_t elementBytes, size_t blockSize,
+             size_t ops, Workload&& run) {
+    size_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+    size_t bytesBefore = allocationBytes.load(std::memory_order_relaxed);
+    auto start = std::chrono::steady_clock::now();
+    {
+        Container c;
+        run(c);
+        auto stop = std::chrono::steady_clock::now();
+        size_t allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+        size_t bytes = allocationBytes.load(std::memory_order_relaxed) - bytesBefore;
+        double ns = std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(ops);
+        std::printf("%-14s %-12s %6zu %7zu %10.2f %12zu %12zu %10zu\n", workload, container, elementBytes,
+                    blockSize, ns, allocations, bytes / 1024, residentBytes() / 1024);
+    }
+}
+
+template <typename Container>
+void fillBack(Container& c, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        c.push_back(typename Container::value_type(i));
+    }
+}
+
+/**************************************************************************************************
+ * @brief Runs every workload against one container type.
+ **************************************************************************************************/
+template <typename Container>
+void runWorkloads(const char* name, size_t blockSize, size_t n) {
+    using T = typename Container::value_type;
+    const size_t bytes = sizeof(T);
+
+    measure<Container>("push_back", name, bytes, blockSize, n, [&](Container& c) {
+        fillBack(c, n);
+    });
+
+    measure<Container>("push_front", name, bytes, blockSize, n, [&](Container& c) {
+        for (size_t i = 0; i < n; ++i) {
+            c.push_front(T(i));
+        }
+    });
+
+    measure<Container>("pop_front", name, bytes, blockSize, 2 * n, [&](Container& c) {
+        fillBack(c, n);
+        for (size_t i = 0; i < n; ++i) {
+            c.pop_front();
+        }
+    });
+
+    measure<Container>("pop_back", name, bytes, blockSize, 2 * n, [&](Container& c) {
+        fillBack(c, n);
+        for (size_t i = 0; i < n; ++i) {
+            c.pop_back();
+        }
+    });
+
+    {
+        Container c;
+        fillBack(c, n);
+        std::mt19937_64 rng(42);
+        std::vector<size_t> indices(n);
+        for (size_t& index : indices) {
+            index = rng() % n;
+        }
+        measure<Container>("random_index", name, bytes, blockSize, n, [&](Container&) {
+            size_t sum = 0;
+            for (size_t index : indices) {
+                sum += c[index].key();
+            }
+            sink = sink + sum;
+        });
+
+        measure<Container>("iterate", name, bytes, blockSize, n, [&](Container&) {
+            size_t sum = 0;
+            for (auto it = c.begin(); it != c.end(); ++it) {
+                sum += (*it).key();
+            }
+            sink = sink + sum;
+        });
+
+        auto byKey = [](const T& a, const T& b) { return a.key() < b.key(); };
+        std::shuffle(c.begin(), c.end(), rng);
+        measure<Container>("sort", name, bytes, blockSize, n, [&](Container&) {
+            std::sort(c.begin(), c.end(), byKey);
+        });
+
+        if constexpr (requires { parallel_sort(c, byKey); }) {
+            std::shuffle(c.begin(), c.end(), rng);
+            measure<Container>("par_sort", name, bytes, blockSize, n, [&](Container&) {
+                parallel_sort(c, byKey);
+            });
+
+            measure<Container>("par_for_each", name, bytes, blockSize, n, [&](Container&) {
+                parallel_for_each(c, [](T& value) { value = T(value.key() + 1); });
+            });
+        }
+    }
+
+    {
+        std::vector<T> source;
+        for (size_t i = 0; i < n; ++i) {
+            source.emplace_back(i);
+        }
+        measure<Container>("bulk_fill", name, bytes, blockSize, n, [&](Container& c) {
+            if constexpr (requires { c.append_range(source); }) {
+                c.append_range(source);
+            } else {
+                c.insert(c.end(), source.begin(), source.end());
+            }
+        });
+    }
+
+    measure<Container>("queue_steady", name, bytes, blockSize, n, [&](Container& c) {
+        const size_t depth = 1024;
+        fillBack(c, depth);
+        for (size_t i = 0; i < n; ++i) {
+            c.push_back(T(i));
+            c.pop_front();
+        }
+    });
+
+    measure<Container>("mixed_ends", name, bytes, blockSize, n, [&](Container& c) {
+        std::mt19937 rng(7);
+        for (size_t i = 0; i < n; ++i) {
+            switch (rng() % 4) {
+            case 0: c.push_back(T(i)); break;
+            case 1: c.push_front(T(i)); break;
+            case 2: if (!c.empty()) c.pop_back(); break;
+            case 3: if (!c.empty()) c.pop_front(); break;
+            }
+        }
+    });
+}
+
+/**************************************************************************************************
+ * @brief Runs the workloads for one element type: std::deque and Deque at several block sizes.
+ **************************************************************************************************/
+template <typename T>
+void runElement(size_t n) {
+    runWorkloads<std::deque<T>>("std::deque", 0, n);
+    runWorkloads<Deque<T, 16>>("Deque", 16, n);
+    runWorkloads<Deque<T, DequeBlockSize<T>::value>>("Deque", DequeBlockSize<T>::value, n);
+    runWorkloads<Deque<T, DequeBlockSize<T, 4096>::value>>("Deque", DequeBlockSize<T, 4096>::value, n);
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? static_cast<size_t>(std::atoll(argv[1])) : (size_t(1) << 20);
+
+    std::printf("%-14s %-12s %6s %7s %10s %12s %12s %10s\n", "workload", "container", "bytes", "block", "ns/op",
+                "allocations", "alloc_kib", "rss_kib");
+    runElement<Payload<4>>(n);
+    runElement<Payload<16>>(n);
+    runElement<Payload<64>>(n);
+    runElement<Payload<256>>(n / 4);
+    return 0;
+}
@@ -0,0 +1,119 @@
+#ifndef CONCURRENT_DEQUE_H
+#define CONCURRENT_DEQUE_H
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "dequeHeader.hpp"
+
+inline constexpr size_t CONCURRENT_DEQUE_CACHE_LINE = 64;
+
+/**************************************************************************************************
+ * @brief Lock-free work-stealing deque (Chase-Lev) over block-segmented storage.
+ * 
+ * The owning thread pushes and pops at the back without locks; any number of thieves take
+ * elements from the front with steal(), which claims an element with a CAS on the front
+ * index. Elements live in fixed-size blocks referenced from a circular block map. Growing
+ * allocates a larger map that reuses the existing blocks, so no element is copied and
+ * thieves holding the old map keep reading valid slots. Retired maps are freed when the
+ * deque is destroyed.
+ * 
+ * @tparam T          Element type; must be trivially copyable (typically a task pointer).
+ * @tparam BLOCK_SIZE Number of elements per block; must be a power of two.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE = DequeBlockSize<T>::value>
+class ConcurrentDeque {
+    static_assert(std::is_trivially_copyable_v<T>, "ConcurrentDeque requires a trivially copyable T.");
+    static_assert(std::has_single_bit(BLOCK_SIZE), "ConcurrentDeque requires a power-of-two BLOCK_SIZE.");
+
+private:
+    static constexpr size_t BLOCK_SHIFT = std::countr_zero(BLOCK_SIZE);
+    static constexpr size_t BLOCK_MASK = BLOCK_SIZE - 1;
+
+    struct BlockMap {
+        size_t capacity;
+        std::atomic<T>** blocks;
+        BlockMap* retired;
+    };
+
+    alignas(CONCURRENT_DEQUE_CACHE_LINE) std::atomic<std::int64_t> top;
+    alignas(CONCURRENT_DEQUE_CACHE_LINE) std::atomic<std::int64_t> bottom;
+    alignas(CONCURRENT_DEQUE_CACHE_LINE) std::atomic<BlockMap*> blockMap;
+
+public:
+    explicit ConcurrentDeque(size_t initialCapacity = 1024);
+    ConcurrentDeque(const ConcurrentDeque&) = delete;
+    ConcurrentDeque& operator=(const ConcurrentDeque&) = delete;
+    ~ConcurrentDeque();
+
+    void push(const T&);
+    std::optional<T> pop();
+    std::optional<T> steal();
+    size_t size() const;
+    bool empty() const;
+    size_t capacity() const;
+
+private:
+    static std::atomic<T>& slot(BlockMap*, std::int64_t);
+    static std::atomic<T>* allocateBlock();
+    BlockMap* growMap(BlockMap*, std::int64_t);
+};
+
+/**************************************************************************************************
+ * @brief Bounded multi-producer/multi-consumer queue for fan-in.
+ * 
+ * A fixed ring of cells, each carrying a sequence number that tells producers and consumers
+ * whether the cell is ready for them (Vyukov's bounded MPMC queue). Producers and consumers
+ * each claim a position with one CAS and never block each other; try_push() fails when the
+ * queue is full and try_pop() fails when it is empty.
+ * 
+ * Once a position is claimed its cell must be published, or every thread behind it waits
+ * forever. So nothing that can throw runs after a claim: an element whose constructor can
+ * throw is built before claiming and only moved into the cell afterwards, and T's move
+ * constructor is required to be noexcept. A throwing constructor leaves the queue untouched.
+ * Nothrow constructions, including try_push(T&&), happen in the claimed cell, so a push that
+ * finds the queue full leaves its argument intact.
+ * 
+ * @tparam T Element type; must be nothrow move constructible.
+ **************************************************************************************************/
+template <typename T>
+class BoundedMPMCQueue {
+    static_assert(std::is_nothrow_move_constructible_v<T>, "BoundedMPMCQueue requires a nothrow move constructible T.");
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    Cell* cells;
+    size_t mask;
+    alignas(CONCURRENT_DEQUE_CACHE_LINE) std::atomic<size_t> enqueuePos;
+    alignas(CONCURRENT_DEQUE_CACHE_LINE) std::atomic<size_t> dequeuePos;
+
+public:
+    explicit BoundedMPMCQueue(size_t capacity);
+    BoundedMPMCQueue(const BoundedMPMCQueue&) = delete;
+    BoundedMPMCQueue& operator=(const BoundedMPMCQueue&) = delete;
+    ~BoundedMPMCQueue();
+
+    bool try_push(const T&);
+    bool try_push(T&&);
+    template <typename... Args>
+    bool try_emplace(Args&&...);
+    std::optional<T> try_pop();
+    size_t capacity() const;
+
+private:
+    template <typename... Args>
+    bool claimAndConstruct(Args&&...);
+};
+
+#include "concurrentDequeImplementation.tpp"
+
+#endif
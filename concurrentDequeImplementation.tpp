@@ -0,0 +1,383 @@
+#include "concurrentDequeHeader.hpp"
+
+/**************************************************************************************************
+ * @brief Constructs an empty work-stealing deque.
+ * 
+ * Allocates a block map with a power-of-two number of blocks, enough for initialCapacity
+ * elements plus the one block of slack that keeps the front and back blocks apart.
+ * 
+ * @param initialCapacity The number of elements the deque can hold before it first grows.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+ConcurrentDeque<T, BLOCK_SIZE>::ConcurrentDeque(size_t initialCapacity)
+    : top(0), bottom(0), blockMap(nullptr) {
+    size_t blocks = std::bit_ceil((initialCapacity + BLOCK_SIZE - 1) / BLOCK_SIZE + 1);
+    if (blocks < 2) {
+        blocks = 2;
+    }
+
+    BlockMap* map = new BlockMap{blocks, new std::atomic<T>*[blocks], nullptr};
+    for (size_t i = 0; i < blocks; ++i) {
+        map->blocks[i] = allocateBlock();
+    }
+    blockMap.store(map, std::memory_order_relaxed);
+}
+
+/**************************************************************************************************
+ * @brief Destructor for the ConcurrentDeque.
+ * 
+ * Frees every block (all of them are referenced by the current map) and every map, including
+ * the retired ones. No other thread may access the deque during destruction.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+ConcurrentDeque<T, BLOCK_SIZE>::~ConcurrentDeque() {
+    BlockMap* map = blockMap.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < map->capacity; ++i) {
+        delete[] map->blocks[i];
+    }
+    while (map != nullptr) {
+        BlockMap* retired = map->retired;
+        delete[] map->blocks;
+        delete map;
+        map = retired;
+    }
+}
+
+/**************************************************************************************************
+ * @brief Pushes an element at the back. Owner thread only.
+ * 
+ * Grows the block map first if the element would not fit. The release fence publishes the
+ * element (and any new map) before the new back index becomes visible to thieves.
+ * 
+ * @param value The element to push.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+void ConcurrentDeque<T, BLOCK_SIZE>::push(const T& value) {
+    std::int64_t b = bottom.load(std::memory_order_relaxed);
+    std::int64_t t = top.load(std::memory_order_acquire);
+    BlockMap* map = blockMap.load(std::memory_order_relaxed);
+    if (b - t >= static_cast<std::int64_t>((map->capacity - 1) * BLOCK_SIZE)) {
+        map = growMap(map, t);
+    }
+    slot(map, b).store(value, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+}
+
+/**************************************************************************************************
+ * @brief Pops the element at the back. Owner thread only.
+ * 
+ * Reserves the back slot by decrementing the back index, then checks the front index. Only
+ * when a single element is left does the owner race thieves for it with a CAS on the front
+ * index.
+ * 
+ * @return The popped element, or std::nullopt if the deque was empty or a thief won the race.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+std::optional<T> ConcurrentDeque<T, BLOCK_SIZE>::pop() {
+    std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    BlockMap* map = blockMap.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t t = top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+
+    T value = slot(map, b).load(std::memory_order_relaxed);
+    if (t == b) {
+        bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        if (!won) {
+            return std::nullopt;
+        }
+    }
+    return value;
+}
+
+/**************************************************************************************************
+ * @brief Steals the element at the front. Safe to call from any thread.
+ * 
+ * Reads the element at the front index and then claims it with a CAS on that index. The
+ * read may see a stale map; that is harmless because growing never moves a live element.
+ * 
+ * @return The stolen element, or std::nullopt if the deque was empty or another thread
+ *         claimed the element first.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+std::optional<T> ConcurrentDeque<T, BLOCK_SIZE>::steal() {
+    std::int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t b = bottom.load(std::memory_order_acquire);
+
+    if (t >= b) {
+        return std::nullopt;
+    }
+
+    BlockMap* map = blockMap.load(std::memory_order_acquire);
+    T value = slot(map, t).load(std::memory_order_relaxed);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+/**************************************************************************************************
+ * @brief Returns the number of elements.
+ * 
+ * The value is a snapshot and may be stale by the time it is used when other threads are
+ * active.
+ * 
+ * @return The number of elements at the time of the call.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+size_t ConcurrentDeque<T, BLOCK_SIZE>::size() const {
+    std::int64_t b = bottom.load(std::memory_order_relaxed);
+    std::int64_t t = top.load(std::memory_order_relaxed);
+    return b > t ? static_cast<size_t>(b - t) : 0;
+}
+
+/**************************************************************************************************
+ * @brief Checks if the deque is empty.
+ * 
+ * @return true if there were no elements at the time of the call; otherwise, false.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+bool ConcurrentDeque<T, BLOCK_SIZE>::empty() const {
+    return size() == 0;
+}
+
+/**************************************************************************************************
+ * @brief Returns the number of elements the deque can hold before it grows.
+ * 
+ * @return The current capacity in elements.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+size_t ConcurrentDeque<T, BLOCK_SIZE>::capacity() const {
+    return (blockMap.load(std::memory_order_acquire)->capacity - 1) * BLOCK_SIZE;
+}
+
+/**************************************************************************************************
+ * @brief Returns the slot holding a given logical index.
+ * 
+ * The block map is circular: index i lives in block (i / BLOCK_SIZE) mod capacity at
+ * offset i mod BLOCK_SIZE, computed with shifts and masks.
+ * 
+ * @param map   The block map to read.
+ * @param index The logical element index.
+ * @return Reference to the slot.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+std::atomic<T>& ConcurrentDeque<T, BLOCK_SIZE>::slot(BlockMap* map, std::int64_t index) {
+    size_t position = static_cast<size_t>(index);
+    return map->blocks[(position >> BLOCK_SHIFT) & (map->capacity - 1)][position & BLOCK_MASK];
+}
+
+/**************************************************************************************************
+ * @brief Allocates one block of atomic slots.
+ * 
+ * @return The new block.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+std::atomic<T>* ConcurrentDeque<T, BLOCK_SIZE>::allocateBlock() {
+    return new std::atomic<T>[BLOCK_SIZE];
+}
+
+/**************************************************************************************************
+ * @brief Doubles the block map. Owner thread only.
+ * 
+ * Walks capacity consecutive block indices starting at the front block and places each old
+ * block at the position the same block index maps to in the new map. The live range spans at
+ * most capacity blocks, so every live element keeps its address, and thieves still reading
+ * the old map see the same slots. The remaining positions get fresh blocks. The old map is
+ * kept on a retired list until destruction, since thieves may still hold it.
+ * 
+ * @param map The current block map.
+ * @param t   The front index observed by the owner.
+ * @return The new block map.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+typename ConcurrentDeque<T, BLOCK_SIZE>::BlockMap*
+ConcurrentDeque<T, BLOCK_SIZE>::growMap(BlockMap* map, std::int64_t t) {
+    size_t newCapacity = map->capacity * 2;
+    BlockMap* newMap = new BlockMap{newCapacity, new std::atomic<T>*[newCapacity], map};
+
+    size_t firstBlock = static_cast<size_t>(t) >> BLOCK_SHIFT;
+    for (size_t k = firstBlock; k < firstBlock + map->capacity; ++k) {
+        newMap->blocks[k & (newCapacity - 1)] = map->blocks[k & (map->capacity - 1)];
+    }
+    for (size_t k = firstBlock + map->capacity; k < firstBlock + newCapacity; ++k) {
+        newMap->blocks[k & (newCapacity - 1)] = allocateBlock();
+    }
+
+    blockMap.store(newMap, std::memory_order_release);
+    return newMap;
+}
+
+/**************************************************************************************************
+ * @brief Constructs a bounded MPMC queue.
+ * 
+ * @param capacity The maximum number of elements; rounded up to a power of two (at least 2).
+ **************************************************************************************************/
+template <typename T>
+BoundedMPMCQueue<T>::BoundedMPMCQueue(size_t capacity)
+    : enqueuePos(0), dequeuePos(0) {
+    size_t size = std::bit_ceil(capacity < 2 ? size_t(2) : capacity);
+    cells = new Cell[size];
+    mask = size - 1;
+    for (size_t i = 0; i < size; ++i) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+/**************************************************************************************************
+ * @brief Destructor for the BoundedMPMCQueue.
+ * 
+ * Destroys the elements still queued. No other thread may access the queue during destruction.
+ **************************************************************************************************/
+template <typename T>
+BoundedMPMCQueue<T>::~BoundedMPMCQueue() {
+    size_t end = enqueuePos.load(std::memory_order_relaxed);
+    for (size_t pos = dequeuePos.load(std::memory_order_relaxed); pos != end; ++pos) {
+        Cell& cell = cells[pos & mask];
+        if (cell.sequence.load(std::memory_order_relaxed) == pos + 1) {
+            std::launder(reinterpret_cast<T*>(cell.storage))->~T();
+        }
+    }
+    delete[] cells;
+}
+
+/**************************************************************************************************
+ * @brief Tries to enqueue a copy of an element.
+ * 
+ * If T's copy constructor can throw, the copy is made before a cell is claimed; otherwise it
+ * is made straight into the claimed cell.
+ * 
+ * @param value The element to enqueue.
+ * @return true on success; false if the queue is full.
+ **************************************************************************************************/
+template <typename T>
+bool BoundedMPMCQueue<T>::try_push(const T& value) {
+    if constexpr (std::is_nothrow_copy_constructible_v<T>) {
+        return claimAndConstruct(value);
+    } else {
+        T copy(value);
+        return claimAndConstruct(std::move(copy));
+    }
+}
+
+/**************************************************************************************************
+ * @brief Tries to move an element into the queue.
+ * 
+ * The element is only moved from once a cell has been claimed, so a call that returns false
+ * leaves value untouched and can simply be retried.
+ * 
+ * @param value The element to enqueue.
+ * @return true on success; false if the queue is full.
+ **************************************************************************************************/
+template <typename T>
+bool BoundedMPMCQueue<T>::try_push(T&& value) {
+    return claimAndConstruct(std::move(value));
+}
+
+/**************************************************************************************************
+ * @brief Tries to construct an element in place at the tail of the queue.
+ * 
+ * When T is nothrow constructible from args the element is built directly in the claimed
+ * cell and the arguments are left untouched if the queue is full. Otherwise it is built in a
+ * temporary before the claim, so an exception from its constructor leaves the queue
+ * unchanged; in that case rvalue arguments are consumed even when the call returns false.
+ * 
+ * @param args Arguments forwarded to the element's constructor.
+ * @return true on success; false if the queue is full.
+ **************************************************************************************************/
+template <typename T>
+template <typename... Args>
+bool BoundedMPMCQueue<T>::try_emplace(Args&&... args) {
+    if constexpr (std::is_nothrow_constructible_v<T, Args&&...>) {
+        return claimAndConstruct(std::forward<Args>(args)...);
+    } else {
+        T value(std::forward<Args>(args)...);
+        return claimAndConstruct(std::move(value));
+    }
+}
+
+/**************************************************************************************************
+ * @brief Claims the cell at the tail of the queue and constructs an element in it.
+ * 
+ * A producer may claim position pos once the cell's sequence equals pos. The element is then
+ * constructed in the cell, which must not throw, and published by setting the sequence to
+ * pos + 1. Nothing is constructed if the queue is full.
+ * 
+ * @param args Arguments forwarded to the element's nothrow constructor.
+ * @return true on success; false if the queue is full.
+ **************************************************************************************************/
+template <typename T>
+template <typename... Args>
+bool BoundedMPMCQueue<T>::claimAndConstruct(Args&&... args) {
+    static_assert(std::is_nothrow_constructible_v<T, Args&&...>);
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+        cell = &cells[pos & mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    ::new (static_cast<void*>(cell->storage)) T(std::forward<Args>(args)...);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+/**************************************************************************************************
+ * @brief Tries to dequeue the element at the head of the queue.
+ * 
+ * A consumer may claim position pos once the cell's sequence equals pos + 1. After moving
+ * the element out it hands the cell to the producer one lap ahead.
+ * 
+ * @return The dequeued element, or std::nullopt if the queue is empty.
+ **************************************************************************************************/
+template <typename T>
+std::optional<T> BoundedMPMCQueue<T>::try_pop() {
+    size_t pos = dequeuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+        cell = &cells[pos & mask];
+        size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1);
+        if (diff == 0) {
+            if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return std::nullopt;
+        } else {
+            pos = dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+    T* element = std::launder(reinterpret_cast<T*>(cell->storage));
+    std::optional<T> value(std::move(*element));
+    element->~T();
+    cell->sequence.store(pos + mask + 1, std::memory_order_release);
+    return value;
+}
+
+/**************************************************************************************************
+ * @brief Returns the maximum number of elements the queue can hold.
+ * 
+ * @return The capacity.
+ **************************************************************************************************/
+template <typename T>
+size_t BoundedMPMCQueue<T>::capacity() const {
+    return mask + 1;
+}
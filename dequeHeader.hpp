@@ -1,37 +1,200 @@
 #ifndef DEQUE_H
 #define DEQUE_H
 
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
  
-template <typename T, size_t BLOCK_SIZE = 4>
+/**************************************************************************************************
+ * @brief Compile-time block size policy.
+ * 
+ * Derives the number of elements per block from sizeof(T) and a target block size in bytes,
+ * rounded down to a power of two so that index arithmetic reduces to shifts and masks.
+ * Blocks always hold at least one element.
+ * 
+ * @tparam T            The element type.
+ * @tparam TARGET_BYTES The desired size of one block in bytes (e.g. 512 or 4096).
+ **************************************************************************************************/
+template <typename T, size_t TARGET_BYTES = 512>
+struct DequeBlockSize {
+    static constexpr size_t value = std::bit_floor(sizeof(T) < TARGET_BYTES ? TARGET_BYTES / sizeof(T) : size_t(1));
+};
+
+/**************************************************************************************************
+ * @brief Point-in-time view of a deque's storage statistics.
+ * 
+ * The counters are cumulative since construction or the last reset_stats(); they stay zero
+ * when statistics are compiled out. The current values at the end are always filled in.
+ **************************************************************************************************/
+struct DequeStatsSnapshot {
+    size_t blockAllocations = 0;       // allocateBlock() calls
+    size_t blockDeallocations = 0;     // deallocateBlock() calls
+    size_t allocatorAllocations = 0;   // blocks requested from the allocator
+    size_t allocatorDeallocations = 0; // blocks returned to the allocator
+    size_t mapGrowths = 0;             // growMap() calls that allocated a larger map
+    size_t mapRecenters = 0;           // growMap() calls that recentered the blocks in place
+    size_t bytesCopied = 0;            // bytes of block pointers moved by growMap()
+    std::chrono::nanoseconds growthTime{0};
+    size_t peakSize = 0;
+    size_t peakBlocks = 0;
+
+    size_t size = 0;
+    size_t blocksInUse = 0;
+    size_t mapSlots = 0;
+    size_t spareBlocks = 0;
+
+    double mapOccupancy() const;
+};
+
+/**************************************************************************************************
+ * @brief Statistics policy that records nothing.
+ * 
+ * The default for Deque. Every hook is empty and the policy takes no space, so the
+ * instrumented code paths compile to the same code as an uninstrumented deque.
+ **************************************************************************************************/
+struct NoDequeStats {
+    static constexpr bool enabled = false;
+
+    void on_allocate_block() {}
+    void on_deallocate_block() {}
+    void on_block_allocated() {}
+    void on_block_freed() {}
+    void on_grow_begin() {}
+    void on_grow_end(bool, size_t) {}
+    void on_size(size_t, size_t) {}
+    void merge(const NoDequeStats&) {}
+    DequeStatsSnapshot snapshot() const { return {}; }
+    void reset() {}
+};
+
+/**************************************************************************************************
+ * @brief Statistics policy that counts block and map traffic and tracks peaks.
+ * 
+ * Every map growth is timed with steady_clock; the total is kept in the snapshot and, if a
+ * growth hook is set, each duration is also passed to it together with whether the map was
+ * reallocated. The hook is the place to forward growth events to a metrics exporter.
+ **************************************************************************************************/
+class DequeStats {
+public:
+    using GrowthHook = std::function<void(std::chrono::nanoseconds, bool)>;
+
+    static constexpr bool enabled = true;
+
+    void set_growth_hook(GrowthHook);
+    void on_allocate_block();
+    void on_deallocate_block();
+    void on_block_allocated();
+    void on_block_freed();
+    void on_grow_begin();
+    void on_grow_end(bool, size_t);
+    void on_size(size_t, size_t);
+    void merge(const DequeStats&);
+    DequeStatsSnapshot snapshot() const;
+    void reset();
+
+private:
+    DequeStatsSnapshot counters;
+    GrowthHook growthHook;
+    std::chrono::steady_clock::time_point growthStart;
+};
+
+inline constexpr char DEQUE_SNAPSHOT_MAGIC[8] = {'D', 'E', 'Q', 'S', 'N', 'A', 'P', '1'};
+inline constexpr std::uint32_t DEQUE_SNAPSHOT_VERSION = 1;
+
+/**************************************************************************************************
+ * @brief Header of a binary Deque snapshot, as written by Deque::save().
+ * 
+ * The header is followed, at offset headerBytes, by the blocks of the deque in order, each
+ * BLOCK_SIZE * sizeof(T) bytes. The first element sits frontOffset slots into the first
+ * block; unused slots before it and after the last element are zero. All fields use the
+ * byte order of the machine that wrote the snapshot, which is checked through the version.
+ * Readers check the element size, alignment and block size; element types that agree on
+ * all three cannot be told apart.
+ **************************************************************************************************/
+struct DequeSnapshotHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t headerBytes;
+    std::uint64_t elementSize;
+    std::uint64_t elementAlignment;
+    std::uint64_t blockSize;
+    std::uint64_t size;
+    std::uint64_t frontOffset;
+    std::uint64_t blocks;
+
+    template <typename T, size_t BLOCK_SIZE>
+    static DequeSnapshotHeader describe(size_t, size_t);
+    template <typename T, size_t BLOCK_SIZE>
+    void validate(std::uintmax_t) const;
+};
+
+template <typename T, size_t BLOCK_SIZE = DequeBlockSize<T>::value, typename Allocator = std::allocator<T>,
+          typename Stats = NoDequeStats>
 class Deque {
+    static_assert(BLOCK_SIZE > 0, "BLOCK_SIZE must be positive.");
+
 private:
+    static constexpr bool BLOCK_IS_POWER_OF_TWO = std::has_single_bit(BLOCK_SIZE);
+    static constexpr size_t BLOCK_SHIFT = std::countr_zero(BLOCK_SIZE);
+    static constexpr size_t BLOCK_MASK = BLOCK_SIZE - 1;
+
+    using AllocTraits = std::allocator_traits<Allocator>;
+    using MapAllocator = typename AllocTraits::template rebind_alloc<T*>;
+    using MapAllocTraits = std::allocator_traits<MapAllocator>;
+
+    [[no_unique_address]] Allocator alloc;
     T** map;
     size_t mapSize;
     size_t frontIndex; 
     size_t backIndex; 
     size_t frontOffset; 
     size_t backOffset; 
+    T** spareBlocks;
+    size_t spareCount;
+    size_t spareCapacity;
+    size_t spareLimit;
+    size_t reservedFront;
+    size_t reservedBack;
+    [[no_unique_address]] Stats statsPolicy;
 
 public:
+    class const_iterator;
+
     class iterator {
     private:
-        Deque* deque;
-        size_t blockIndex;
-        size_t offset;
+        T* cur;
+        T* first;
+        T** node;
+        friend class const_iterator;
     public:
         using difference_type = std::ptrdiff_t;
         using value_type = T;
         using pointer = T*;
         using reference = T&;
         using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::random_access_iterator_tag;
 
-        iterator(Deque*, size_t, size_t);
+        iterator();
+        iterator(T**, T*);
         reference operator*() const;
+        pointer operator->() const;
+        reference operator[](difference_type) const;
         iterator& operator++();
         iterator operator++(int);
-        iterator operator--();
+        iterator& operator--();
         iterator operator--(int);
         iterator& operator+=(difference_type);
         iterator operator+(difference_type n) const;
@@ -44,25 +207,33 @@ public:
         bool operator>(const iterator&) const;
         bool operator<=(const iterator&) const;
         bool operator>=(const iterator&) const;
+        friend iterator operator+(difference_type n, const iterator& it) { return it + n; }
+    private:
+        void setNode(T**);
     };
     
     class const_iterator {
     private:
-        const Deque* deque;
-        size_t blockIndex;
-        size_t offset;
+        const T* cur;
+        const T* first;
+        T* const* node;
     public:
         using difference_type = std::ptrdiff_t;
         using value_type = T;
         using pointer = const T*;
         using reference = const T&;
         using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::random_access_iterator_tag;
 
-        const_iterator(const Deque*, size_t, size_t);
+        const_iterator();
+        const_iterator(T* const*, const T*);
+        const_iterator(const iterator&);
         reference operator*() const;
+        pointer operator->() const;
+        reference operator[](difference_type) const;
         const_iterator& operator++();
         const_iterator operator++(int);
-        const_iterator operator--();
+        const_iterator& operator--();
         const_iterator operator--(int);
         const_iterator& operator+=(difference_type);
         const_iterator operator+(difference_type n) const;
@@ -75,13 +246,67 @@ public:
         bool operator>(const const_iterator&) const;
         bool operator<=(const const_iterator&) const;
         bool operator>=(const const_iterator&) const;
+        friend const_iterator operator+(difference_type n, const const_iterator& it) { return it + n; }
+    private:
+        void setNode(T* const*);
     };
 
-    Deque(size_t initialSize = 4);
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using allocator_type = Allocator;
+
+    static constexpr size_t DEFAULT_SPARE_LIMIT = 4;
+
+    explicit Deque(const Allocator&);
+    Deque(size_t initialSize = 0, const Allocator& = Allocator());
+    Deque(const Deque&);
+    Deque(Deque&&) noexcept;
     ~Deque();
+    Deque& operator=(const Deque&);
+    Deque& operator=(Deque&&) noexcept(AllocTraits::propagate_on_container_move_assignment::value ||
+                                       AllocTraits::is_always_equal::value);
+    allocator_type get_allocator() const;
     bool empty() const;
     void push_front(const T&);
+    void push_front(T&&);
     void push_back(const T&);
+    void push_back(T&&);
+    template <typename... Args>
+    T& emplace_front(Args&&...);
+    template <typename... Args>
+    T& emplace_back(Args&&...);
+    void pop_front();
+    void pop_back();
+    T& front();
+    const T& front() const;
+    T& back();
+    const T& back() const;
+    void clear();
+    template <std::ranges::input_range R>
+    void append_range(R&&);
+    template <std::ranges::input_range R>
+    void prepend_range(R&&);
+    template <std::ranges::input_range R>
+    void assign(R&&);
+    template <typename F>
+    void for_each_segment(F&&);
+    template <typename F>
+    void for_each_segment(F&&) const;
+    T* copy_out(T*) const;
+    void save(const std::filesystem::path&) const requires std::is_trivially_copyable_v<T>;
+    void load(const std::filesystem::path&) requires std::is_trivially_copyable_v<T>;
+    void shrink_to_fit();
+    void reserve_front(size_t);
+    void reserve_back(size_t);
+    size_t spare_block_limit() const;
+    void set_spare_block_limit(size_t);
+    size_t spare_blocks() const;
+    DequeStatsSnapshot stats() const;
+    void reset_stats();
+    Stats& stats_policy();
     T& operator[](size_t);
     T& at(size_t);    
     size_t size() const;
@@ -91,10 +316,32 @@ public:
     const_iterator cend() const;
 
 private:
+    static constexpr size_t blockOf(size_t);
+    static constexpr size_t offsetOf(size_t);
+    static constexpr size_t slotsIn(size_t);
+    void initializeStorage(size_t);
+    void ensureStorage();
+    void releaseStorage();
+    void resetStorage() noexcept;
+    void destroyElements();
+    template <typename It>
+    It constructRange(It, T*, size_t);
+    void stealStorage(Deque&) noexcept;
+    static void writePadding(std::ostream&, size_t);
     void initializeMap(size_t);
+    T** allocateMap(size_t);
+    void deallocateMap(T**, size_t);
+    T* newBlock();
+    void freeBlock(T*);
     void allocateBlock(size_t);
     void deallocateBlock(size_t);
-    void growMap();
+    void recordPeak();
+    void releaseSpareBlocks();
+    void resizeSpareCache(size_t);
+    void reserveSpareBlocks();
+    void reserveMapFront(size_t);
+    void reserveMapBack(size_t);
+    void growMap(size_t, bool);
 };
 
 #include "dequeImplementation.tpp" 
@@ -1,41 +1,242 @@
 #include "dequeHeader.hpp"
 
 /**************************************************************************************************
- * @brief Constructs an iterator for the deque.
+ * @brief Returns the fraction of map slots that hold blocks in use.
+ * 
+ * @return blocksInUse / mapSlots, or 0 if the snapshot has no map.
+ **************************************************************************************************/
+inline double DequeStatsSnapshot::mapOccupancy() const {
+    return mapSlots ? static_cast<double>(blocksInUse) / static_cast<double>(mapSlots) : 0.0;
+}
+
+/**************************************************************************************************
+ * @brief Sets the function called with the duration of every map growth.
+ * 
+ * @param hook The function to call, or an empty function to stop reporting.
+ **************************************************************************************************/
+inline void DequeStats::set_growth_hook(GrowthHook hook) {
+    growthHook = std::move(hook);
+}
+
+/**************************************************************************************************
+ * @brief Counts a call to allocateBlock().
+ **************************************************************************************************/
+inline void DequeStats::on_allocate_block() {
+    ++counters.blockAllocations;
+}
+
+/**************************************************************************************************
+ * @brief Counts a call to deallocateBlock().
+ **************************************************************************************************/
+inline void DequeStats::on_deallocate_block() {
+    ++counters.blockDeallocations;
+}
+
+/**************************************************************************************************
+ * @brief Counts a block requested from the allocator.
+ **************************************************************************************************/
+inline void DequeStats::on_block_allocated() {
+    ++counters.allocatorAllocations;
+}
+
+/**************************************************************************************************
+ * @brief Counts a block returned to the allocator.
+ **************************************************************************************************/
+inline void DequeStats::on_block_freed() {
+    ++counters.allocatorDeallocations;
+}
+
+/**************************************************************************************************
+ * @brief Starts timing a map growth.
+ **************************************************************************************************/
+inline void DequeStats::on_grow_begin() {
+    growthStart = std::chrono::steady_clock::now();
+}
+
+/**************************************************************************************************
+ * @brief Records a finished map growth and reports its duration to the growth hook.
+ * 
+ * @param reallocated true if a larger map was allocated, false if the blocks were recentered.
+ * @param bytesCopied The number of bytes of block pointers moved.
+ **************************************************************************************************/
+inline void DequeStats::on_grow_end(bool reallocated, size_t bytesCopied) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - growthStart);
+    ++(reallocated ? counters.mapGrowths : counters.mapRecenters);
+    counters.bytesCopied += bytesCopied;
+    counters.growthTime += elapsed;
+    if (growthHook) {
+        growthHook(elapsed, reallocated);
+    }
+}
+
+/**************************************************************************************************
+ * @brief Updates the peak size and peak number of blocks in use.
+ * 
+ * @param size   The current number of elements.
+ * @param blocks The current number of blocks in use.
+ **************************************************************************************************/
+inline void DequeStats::on_size(size_t size, size_t blocks) {
+    counters.peakSize = std::max(counters.peakSize, size);
+    counters.peakBlocks = std::max(counters.peakBlocks, blocks);
+}
+
+/**************************************************************************************************
+ * @brief Adds the counters of another policy to this one.
+ * 
+ * Used when a deque takes over storage that was built under a temporary policy, so that
+ * blocks allocated there and freed here still balance. Peaks are combined by taking the
+ * larger one.
+ * 
+ * @param other The policy whose counters are added.
+ **************************************************************************************************/
+inline void DequeStats::merge(const DequeStats& other) {
+    counters.blockAllocations += other.counters.blockAllocations;
+    counters.blockDeallocations += other.counters.blockDeallocations;
+    counters.allocatorAllocations += other.counters.allocatorAllocations;
+    counters.allocatorDeallocations += other.counters.allocatorDeallocations;
+    counters.mapGrowths += other.counters.mapGrowths;
+    counters.mapRecenters += other.counters.mapRecenters;
+    counters.bytesCopied += other.counters.bytesCopied;
+    counters.growthTime += other.counters.growthTime;
+    counters.peakSize = std::max(counters.peakSize, other.counters.peakSize);
+    counters.peakBlocks = std::max(counters.peakBlocks, other.counters.peakBlocks);
+}
+
+/**************************************************************************************************
+ * @brief Returns a copy of the counters.
+ * 
+ * @return The cumulative counters; the current values are filled in by Deque::stats().
+ **************************************************************************************************/
+inline DequeStatsSnapshot DequeStats::snapshot() const {
+    return counters;
+}
+
+/**************************************************************************************************
+ * @brief Resets every counter to zero. The growth hook is kept.
+ **************************************************************************************************/
+inline void DequeStats::reset() {
+    counters = DequeStatsSnapshot();
+}
+
+/**************************************************************************************************
+ * @brief Builds the snapshot header for a deque of T with the given layout.
+ * 
+ * The payload starts at a multiple of 64 bytes (or of alignof(T), if larger), so a mapped
+ * snapshot is suitably aligned for T.
+ * 
+ * @param size        The number of elements.
+ * @param frontOffset The slot of the first element inside the first block.
+ * @return The filled-in header.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+DequeSnapshotHeader DequeSnapshotHeader::describe(size_t size, size_t frontOffset) {
+    DequeSnapshotHeader header;
+    std::memcpy(header.magic, DEQUE_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = DEQUE_SNAPSHOT_VERSION;
+    header.headerBytes = static_cast<std::uint32_t>(std::max<size_t>(64, alignof(T)));
+    header.elementSize = sizeof(T);
+    header.elementAlignment = alignof(T);
+    header.blockSize = BLOCK_SIZE;
+    header.size = size;
+    header.frontOffset = frontOffset;
+    header.blocks = (frontOffset + size) / BLOCK_SIZE + 1;
+    return header;
+}
+
+/**************************************************************************************************
+ * @brief Checks that a snapshot header was written for T and BLOCK_SIZE and fits the file.
  * 
- * @param d Pointer to the deque object.
- * @param bIdx Starting block index in the deque's map.
- * @param off  Starting offset within the block.
+ * Throws a std::runtime_error if the header is not a snapshot header, if the element size,
+ * alignment or block size differ from this instantiation, or if the layout it describes does
+ * not match the file size.
+ * 
+ * @param fileBytes The size of the snapshot file in bytes.
  **************************************************************************************************/
 template <typename T, size_t BLOCK_SIZE>
-Deque<T, BLOCK_SIZE>::iterator::iterator(Deque<T, BLOCK_SIZE>* d, size_t bIdx, size_t off)
-    : deque(d), blockIndex(bIdx), offset(off) {}
+void DequeSnapshotHeader::validate(std::uintmax_t fileBytes) const {
+    if (std::memcmp(magic, DEQUE_SNAPSHOT_MAGIC, sizeof(magic)) != 0 || version != DEQUE_SNAPSHOT_VERSION) {
+        throw std::runtime_error("Not a Deque snapshot.\n");
+    }
+    if (elementSize != sizeof(T) || elementAlignment != alignof(T)) {
+        throw std::runtime_error("Snapshot element type does not match.\n");
+    }
+    if (blockSize != BLOCK_SIZE) {
+        throw std::runtime_error("Snapshot block size does not match.\n");
+    }
+    if (headerBytes < sizeof(DequeSnapshotHeader) || headerBytes % alignof(T) != 0 || frontOffset >= BLOCK_SIZE ||
+        size > fileBytes || blocks != (frontOffset + size) / BLOCK_SIZE + 1 ||
+        fileBytes != headerBytes + blocks * BLOCK_SIZE * sizeof(T)) {
+        throw std::runtime_error("Snapshot is corrupt or truncated.\n");
+    }
+}
+
+/**************************************************************************************************
+ * @brief Constructs a singular iterator that refers to no deque.
+ * 
+ * It may only be assigned to, compared with another singular iterator or destroyed.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::iterator()
+    : cur(nullptr), first(nullptr), node(nullptr) {}
+
+/**************************************************************************************************
+ * @brief Constructs an iterator for the deque.
+ * 
+ * @param n Pointer to the map slot of the block holding the position.
+ * @param c Pointer to the element at the position inside that block.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::iterator(T** n, T* c)
+    : cur(c), first(*n), node(n) {}
 
 /**************************************************************************************************
  * @brief Dereferences the iterator to access the element.
  * 
  * @return Reference to the element at the current iterator position.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-typename Deque<T, BLOCK_SIZE>::iterator::reference 
-Deque<T, BLOCK_SIZE>::iterator::operator*() const {
-    return deque->map[blockIndex][offset];
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::reference 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::operator*() const {
+    return *cur;
+}
+
+/**************************************************************************************************
+ * @brief Member access through the iterator.
+ * 
+ * @return Pointer to the element at the current iterator position.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::pointer 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::operator->() const {
+    return cur;
+}
+
+/**************************************************************************************************
+ * @brief Accesses the element a given number of positions away.
+ * 
+ * @param n Displacement from the current position.
+ * @return Reference to the element at that position.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::reference 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::operator[](typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::difference_type n) const {
+    return *(*this + n);
 }
 
 /**************************************************************************************************
  * @brief Pre-increment operator.
  * 
- * Moves the iterator forward by one element. If the offset reaches BLOCK_SIZE,
- * it resets the offset to 0 and increments the block index.
+ * Moves the iterator forward by one element. When it runs off the end of its block, it
+ * steps to the first slot of the next block.
  * 
  * @return Reference to the updated iterator.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-typename Deque<T, BLOCK_SIZE>::iterator& 
-Deque<T, BLOCK_SIZE>::iterator::operator++() {
-    if (++offset == BLOCK_SIZE) {
-        offset = 0;
-        ++blockIndex;
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator& 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::operator++() {
+    if (++cur == first + BLOCK_SIZE) {
+        setNode(node + 1);
+        cur = first;
     }
     return *this;
 }
@@ -47,10 +248,10 @@ Deque<T, BLOCK_SIZE>::iterator::operator++() {
  * 
  * @return A copy of the iterator before it was incremented.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-typename Deque<T, BLOCK_SIZE>::iterator 
-Deque<T, BLOCK_SIZE>::iterator::operator++(int) {
-    typename Deque<T, BLOCK_SIZE>::iterator temp = *this;
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::operator++(int) {
+    typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator temp = *this;
     ++(*this);
     return temp;
 }
@@ -58,18 +259,19 @@ Deque<T, BLOCK_SIZE>::iterator::operator++(int) {
 /**************************************************************************************************
  * @brief Pre-decrement operator.
  * 
- * Moves the iterator backward by one element. If decrementing the offset makes it zero,
- * the offset is set to BLOCK_SIZE and the block index is decremented.
+ * Moves the iterator backward by one element. If it is at the start of its block, the
+ * iterator steps to the last slot of the previous block.
  * 
  * @return Reference to the updated iterator.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-typename Deque<T, BLOCK_SIZE>::iterator& 
-Deque<T, BLOCK_SIZE>::iterator::operator--() {
-    if (--offset == 0) {
-        offset = BLOCK_SIZE;
-        --blockIndex;
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator& 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::operator--() {
+    if (cur == first) {
+        setNode(node - 1);
+        cur = first + BLOCK_SIZE;
     }
+    --cur;
     return *this;
 }
 
@@ -80,10 +282,10 @@ Deque<T, BLOCK_SIZE>::iterator::operator--() {
  * 
  * @return A copy of the iterator before it was decremented.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-typename Deque<T, BLOCK_SIZE>::iterator 
-Deque<T, BLOCK_SIZE>::iterator::operator--(int) {
-    typename Deque<T, BLOCK_SIZE>::iterator temp = *this;
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::operator--(int) {
+    typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator temp = *this;
     --(*this);
     return temp;
 }
@@ -91,16 +293,25 @@ Deque<T, BLOCK_SIZE>::iterator::operator--(int) {
 /**************************************************************************************************
  * @brief Advances the iterator by a given number of positions.
  * 
- * Uses arithmetic to compute the new block index and offset based on the input displacement.
+ * Moves within the current block with plain pointer arithmetic. Only when the target lies
+ * in another block is the displacement split into whole blocks and an offset; BLOCK_SIZE
+ * is a compile-time constant, so the split is a shift or a multiply, never a divide.
  * 
- * @param n Number of positions to advance.
+ * @param n Number of positions to advance (may be negative).
  * @return Reference to the updated iterator.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-typename Deque<T, BLOCK_SIZE>::iterator& 
-Deque<T, BLOCK_SIZE>::iterator::operator+=(typename Deque<T, BLOCK_SIZE>::iterator::difference_type n) {
-    blockIndex += (offset + n) / BLOCK_SIZE;
-    offset = (offset + n) % BLOCK_SIZE;
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator& 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::operator+=(typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::difference_type n) {
+    constexpr difference_type BLOCK = static_cast<difference_type>(BLOCK_SIZE);
+    difference_type position = (cur - first) + n;
+    if (position >= 0 && position < BLOCK) {
+        cur += n;
+    } else {
+        difference_type blocks = position >= 0 ? position / BLOCK : -((-position - 1) / BLOCK) - 1;
+        setNode(node + blocks);
+        cur = first + (position - blocks * BLOCK);
+    }
     return *this;
 }
 
@@ -112,10 +323,10 @@ Deque<T, BLOCK_SIZE>::iterator::operator+=(typename Deque<T, BLOCK_SIZE>::iterat
  * @param n Number of positions to advance.
  * @return Iterator advanced by n positions.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-typename Deque<T, BLOCK_SIZE>::iterator 
-Deque<T, BLOCK_SIZE>::iterator::operator+(typename Deque<T, BLOCK_SIZE>::iterator::difference_type n) const {
-    typename Deque<T, BLOCK_SIZE>::iterator temp = *this;
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::operator+(typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::difference_type n) const {
+    typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator temp = *this;
     return temp += n;
 }
 
@@ -127,9 +338,9 @@ Deque<T, BLOCK_SIZE>::iterator::operator+(typename Deque<T, BLOCK_SIZE>::iterato
  * @param n Number of positions to move backward.
  * @return Reference to the updated iterator.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-typename Deque<T, BLOCK_SIZE>::iterator& 
-Deque<T, BLOCK_SIZE>::iterator::operator-=(typename Deque<T, BLOCK_SIZE>::iterator::difference_type n) {
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator& 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::operator-=(typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::difference_type n) {
     return *this += -n;
 }
 
@@ -141,38 +352,39 @@ Deque<T, BLOCK_SIZE>::iterator::operator-=(typename Deque<T, BLOCK_SIZE>::iterat
  * @param n Number of positions to move backward.
  * @return Iterator moved backward by n positions.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-typename Deque<T, BLOCK_SIZE>::iterator 
-Deque<T, BLOCK_SIZE>::iterator::operator-(typename Deque<T, BLOCK_SIZE>::iterator::difference_type n) const {
-    typename Deque<T, BLOCK_SIZE>::iterator temp = *this;
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::operator-(typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::difference_type n) const {
+    typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator temp = *this;
     return temp -= n;
 }
 
 /**************************************************************************************************
  * @brief Calculates the distance between two iterators.
  * 
- * Computes the difference based on the block index and offset differences.
+ * Counts the whole blocks between the two map slots and corrects for the offsets inside
+ * the first and last block.
  * 
  * @param other The iterator to subtract.
  * @return The difference (number of elements) between this iterator and other.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-typename Deque<T, BLOCK_SIZE>::iterator::difference_type 
-Deque<T, BLOCK_SIZE>::iterator::operator-(const typename Deque<T, BLOCK_SIZE>::iterator& other) const {
-    return (blockIndex - other.blockIndex) * BLOCK_SIZE + (offset - other.offset);
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::difference_type 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::operator-(const typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator& other) const {
+    return static_cast<difference_type>(BLOCK_SIZE) * (node - other.node) + (cur - first) - (other.cur - other.first);
 }
 
 /**************************************************************************************************
  * @brief Equality comparison for iterators.
  * 
- * Checks if two iterators are at the same block and offset.
+ * Every position has exactly one element address, so comparing those is enough.
  * 
  * @param other The iterator to compare with.
  * @return true if both iterators point to the same position; otherwise, false.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-bool Deque<T, BLOCK_SIZE>::iterator::operator==(const typename Deque<T, BLOCK_SIZE>::iterator& other) const {
-    return ((blockIndex == other.blockIndex) && (offset == other.offset));
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+bool Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::operator==(const typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator& other) const {
+    return cur == other.cur;
 }
 
 /**************************************************************************************************
@@ -183,22 +395,22 @@ bool Deque<T, BLOCK_SIZE>::iterator::operator==(const typename Deque<T, BLOCK_SI
  * @param other The iterator to compare with.
  * @return true if the iterators are not equal; otherwise, false.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-bool Deque<T, BLOCK_SIZE>::iterator::operator!=(const typename Deque<T, BLOCK_SIZE>::iterator& other) const {
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+bool Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::operator!=(const typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator& other) const {
     return !(*this == other);
 }
 
 /**************************************************************************************************
  * @brief Less-than comparison for iterators.
  * 
- * Determines if the current iterator precedes another based on block index and offset.
+ * Determines if the current iterator precedes another based on map slot and element address.
  * 
  * @param other The iterator to compare with.
  * @return true if this iterator is before other; otherwise, false.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-bool Deque<T, BLOCK_SIZE>::iterator::operator<(const typename Deque<T, BLOCK_SIZE>::iterator& other) const {
-    return blockIndex < other.blockIndex || (blockIndex == other.blockIndex && offset < other.offset);
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+bool Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::operator<(const typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator& other) const {
+    return node == other.node ? cur < other.cur : node < other.node;
 }
 
 /**************************************************************************************************
@@ -209,8 +421,8 @@ bool Deque<T, BLOCK_SIZE>::iterator::operator<(const typename Deque<T, BLOCK_SIZ
  * @param other The iterator to compare with.
  * @return true if this iterator is after other; otherwise, false.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-bool Deque<T, BLOCK_SIZE>::iterator::operator>(const typename Deque<T, BLOCK_SIZE>::iterator& other) const {
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+bool Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::operator>(const typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator& other) const {
     return other < *this;
 }
 
@@ -222,8 +434,8 @@ bool Deque<T, BLOCK_SIZE>::iterator::operator>(const typename Deque<T, BLOCK_SIZ
  * @param other The iterator to compare with.
  * @return true if this iterator is not after the other; otherwise, false.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-bool Deque<T, BLOCK_SIZE>::iterator::operator<=(const typename Deque<T, BLOCK_SIZE>::iterator& other) const {
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+bool Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::operator<=(const typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator& other) const {
     return !(other < *this);
 }
 
@@ -235,400 +447,1239 @@ bool Deque<T, BLOCK_SIZE>::iterator::operator<=(const typename Deque<T, BLOCK_SI
  * @param other The iterator to compare with.
  * @return true if this iterator is not before the other; otherwise, false.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-bool Deque<T, BLOCK_SIZE>::iterator::operator>=(const typename Deque<T, BLOCK_SIZE>::iterator& other) const {
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+bool Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::operator>=(const typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator& other) const {
     return !(*this < other);
 }
 
+/**************************************************************************************************
+ * @brief Moves the iterator to another map slot and caches that block's start.
+ * 
+ * @param n Pointer to the new map slot.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator::setNode(T** n) {
+    node = n;
+    first = *n;
+}
+
+/**************************************************************************************************
+ * @brief Constructs a singular const_iterator that refers to no deque.
+ * 
+ * It may only be assigned to, compared with another singular iterator or destroyed.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::const_iterator()
+    : cur(nullptr), first(nullptr), node(nullptr) {}
+
 /**************************************************************************************************
  * @brief Constructs a const_iterator for the deque.
  * 
- * @param d Pointer to the constant deque.
- * @param bIdx Starting block index.
- * @param off  Starting offset within the block.
+ * @param n Pointer to the map slot of the block holding the position.
+ * @param c Pointer to the element at the position inside that block.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-Deque<T, BLOCK_SIZE>::const_iterator::const_iterator(const Deque<T, BLOCK_SIZE>* d, size_t bIdx, size_t off)
-    : deque(d), blockIndex(bIdx), offset(off) {}
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::const_iterator(T* const* n, const T* c)
+    : cur(c), first(*n), node(n) {}
 
 /**************************************************************************************************
- * @brief Dereferences the const_iterator to access the element.
+ * @brief Converts a mutable iterator into a const_iterator at the same position.
  * 
- * @return Constant reference to the element at the current const_iterator position.
+ * @param it The iterator to convert.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-typename Deque<T, BLOCK_SIZE>::const_iterator::reference 
-Deque<T, BLOCK_SIZE>::const_iterator::operator*() const { 
-    return deque->map[blockIndex][offset]; 
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::const_iterator(const typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator& it)
+    : cur(it.cur), first(it.first), node(it.node) {}
+
+/**************************************************************************************************
+ * @brief Dereferences the iterator to access the element.
+ * 
+ * @return Reference to the element at the current iterator position.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::reference 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::operator*() const {
+    return *cur;
+}
+
+/**************************************************************************************************
+ * @brief Member access through the iterator.
+ * 
+ * @return Pointer to the element at the current iterator position.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::pointer 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::operator->() const {
+    return cur;
+}
+
+/**************************************************************************************************
+ * @brief Accesses the element a given number of positions away.
+ * 
+ * @param n Displacement from the current position.
+ * @return Reference to the element at that position.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::reference 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::operator[](typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::difference_type n) const {
+    return *(*this + n);
 }
 
 /**************************************************************************************************
- * @brief Pre-increment operator for const_iterator.
+ * @brief Pre-increment operator.
  * 
- * Advances the const_iterator by one element, adjusting block index and offset as needed.
+ * Moves the iterator forward by one element. When it runs off the end of its block, it
+ * steps to the first slot of the next block.
  * 
- * @return Reference to the updated const_iterator.
+ * @return Reference to the updated iterator.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-typename Deque<T, BLOCK_SIZE>::const_iterator& 
-Deque<T, BLOCK_SIZE>::const_iterator::operator++() {
-    if (++offset == BLOCK_SIZE) {
-        offset = 0;
-        ++blockIndex;
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator& 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::operator++() {
+    if (++cur == first + BLOCK_SIZE) {
+        setNode(node + 1);
+        cur = first;
     }
     return *this;
 }
 
 /**************************************************************************************************
- * @brief Post-increment operator for const_iterator.
+ * @brief Post-increment operator.
  * 
- * Returns the state of the const_iterator before advancing it by one element.
+ * Returns the iterator state before incrementing. The iterator is then advanced by one element.
  * 
- * @return A copy of the const_iterator before it was incremented.
+ * @return A copy of the iterator before it was incremented.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-typename Deque<T, BLOCK_SIZE>::const_iterator 
-Deque<T, BLOCK_SIZE>::const_iterator::operator++(int) {
-    typename Deque<T, BLOCK_SIZE>::const_iterator temp = *this;
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::operator++(int) {
+    typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator temp = *this;
     ++(*this);
     return temp;
 }
 
 /**************************************************************************************************
- * @brief Pre-decrement operator for const_iterator.
+ * @brief Pre-decrement operator.
  * 
- * Moves the const_iterator backward by one element. Adjusts the block index and offset accordingly.
+ * Moves the iterator backward by one element. If it is at the start of its block, the
+ * iterator steps to the last slot of the previous block.
  * 
- * @return Reference to the updated const_iterator.
+ * @return Reference to the updated iterator.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-typename Deque<T, BLOCK_SIZE>::const_iterator& 
-Deque<T, BLOCK_SIZE>::const_iterator::operator--() {
-    if (offset == 0) {
-        offset = BLOCK_SIZE;
-        --blockIndex;
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator& 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::operator--() {
+    if (cur == first) {
+        setNode(node - 1);
+        cur = first + BLOCK_SIZE;
     }
-    --offset;
+    --cur;
     return *this;
 }
 
 /**************************************************************************************************
- * @brief Post-decrement operator for const_iterator.
+ * @brief Post-decrement operator.
  * 
- * Returns the state of the const_iterator before moving it backward by one element.
+ * Returns the iterator state before decrementing. The iterator is then moved backward by one element.
  * 
- * @return A copy of the const_iterator before it was decremented.
+ * @return A copy of the iterator before it was decremented.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-typename Deque<T, BLOCK_SIZE>::const_iterator 
-Deque<T, BLOCK_SIZE>::const_iterator::operator--(int) {
-    typename Deque<T, BLOCK_SIZE>::const_iterator temp = *this;
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::operator--(int) {
+    typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator temp = *this;
     --(*this);
     return temp;
 }
 
 /**************************************************************************************************
- * @brief Advances the const_iterator by a given number of positions.
+ * @brief Advances the iterator by a given number of positions.
  * 
- * Adjusts the block index and offset using arithmetic to move forward.
+ * Moves within the current block with plain pointer arithmetic. Only when the target lies
+ * in another block is the displacement split into whole blocks and an offset; BLOCK_SIZE
+ * is a compile-time constant, so the split is a shift or a multiply, never a divide.
  * 
- * @param n Number of positions to advance.
- * @return Reference to the updated const_iterator.
+ * @param n Number of positions to advance (may be negative).
+ * @return Reference to the updated iterator.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-typename Deque<T, BLOCK_SIZE>::const_iterator& 
-Deque<T, BLOCK_SIZE>::const_iterator::operator+=(typename Deque<T, BLOCK_SIZE>::const_iterator::difference_type n) {
-    blockIndex += (offset + n) / BLOCK_SIZE;
-    offset = (offset + n) % BLOCK_SIZE;
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator& 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::operator+=(typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::difference_type n) {
+    constexpr difference_type BLOCK = static_cast<difference_type>(BLOCK_SIZE);
+    difference_type position = (cur - first) + n;
+    if (position >= 0 && position < BLOCK) {
+        cur += n;
+    } else {
+        difference_type blocks = position >= 0 ? position / BLOCK : -((-position - 1) / BLOCK) - 1;
+        setNode(node + blocks);
+        cur = first + (position - blocks * BLOCK);
+    }
     return *this;
 }
 
 /**************************************************************************************************
- * @brief Returns a const_iterator advanced by a given number of positions.
+ * @brief Returns an iterator advanced by a given number of positions.
  * 
- * Creates a temporary copy, advances it, and returns the new const_iterator.
+ * Creates a temporary copy of the iterator, advances it, and returns the copy.
  * 
  * @param n Number of positions to advance.
- * @return const_iterator advanced by n positions.
+ * @return Iterator advanced by n positions.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-typename Deque<T, BLOCK_SIZE>::const_iterator 
-Deque<T, BLOCK_SIZE>::const_iterator::operator+(typename Deque<T, BLOCK_SIZE>::const_iterator::difference_type n) const {
-    typename Deque<T, BLOCK_SIZE>::const_iterator temp = *this;
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::operator+(typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::difference_type n) const {
+    typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator temp = *this;
     return temp += n;
 }
 
 /**************************************************************************************************
- * @brief Moves the const_iterator backward by a given number of positions.
+ * @brief Moves the iterator backward by a given number of positions.
  * 
- * Utilizes negative advancement to move the iterator backward.
+ * This function subtracts positions by adding the negative of n.
  * 
  * @param n Number of positions to move backward.
- * @return Reference to the updated const_iterator.
+ * @return Reference to the updated iterator.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-typename Deque<T, BLOCK_SIZE>::const_iterator& 
-Deque<T, BLOCK_SIZE>::const_iterator::operator-=(typename Deque<T, BLOCK_SIZE>::const_iterator::difference_type n) const {
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator& 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::operator-=(typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::difference_type n) {
     return *this += -n;
 }
 
 /**************************************************************************************************
- * @brief Returns a const_iterator moved backward by a given number of positions.
+ * @brief Returns an iterator moved backward by a given number of positions.
  * 
- * Creates a temporary copy, moves it backward, and returns it.
+ * Creates a temporary copy of the iterator, moves it backward, and returns the copy.
  * 
  * @param n Number of positions to move backward.
- * @return const_iterator moved backward by n positions.
+ * @return Iterator moved backward by n positions.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-typename Deque<T, BLOCK_SIZE>::const_iterator 
-Deque<T, BLOCK_SIZE>::const_iterator::operator-(typename Deque<T, BLOCK_SIZE>::const_iterator::difference_type n) const {
-    typename Deque<T, BLOCK_SIZE>::const_iterator temp = *this;
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::operator-(typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::difference_type n) const {
+    typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator temp = *this;
     return temp -= n;
 }
 
 /**************************************************************************************************
- * @brief Calculates the distance between two const_iterators.
+ * @brief Calculates the distance between two iterators.
  * 
- * Determines the difference in positions based on block index and offset.
+ * Counts the whole blocks between the two map slots and corrects for the offsets inside
+ * the first and last block.
  * 
- * @param other The const_iterator to subtract.
+ * @param other The iterator to subtract.
  * @return The difference (number of elements) between this iterator and other.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-typename Deque<T, BLOCK_SIZE>::const_iterator::difference_type 
-Deque<T, BLOCK_SIZE>::const_iterator::operator-(const typename Deque<T, BLOCK_SIZE>::const_iterator& other) const {
-    return (blockIndex - other.blockIndex) * BLOCK_SIZE + (offset - other.offset);
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::difference_type 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::operator-(const typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator& other) const {
+    return static_cast<difference_type>(BLOCK_SIZE) * (node - other.node) + (cur - first) - (other.cur - other.first);
 }
 
 /**************************************************************************************************
- * @brief Equality comparison for const_iterators.
+ * @brief Equality comparison for iterators.
  * 
- * Checks if both const_iterators point to the same block and offset.
+ * Every position has exactly one element address, so comparing those is enough.
  * 
- * @param other The const_iterator to compare with.
- * @return true if they are equal; otherwise, false.
+ * @param other The iterator to compare with.
+ * @return true if both iterators point to the same position; otherwise, false.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-bool Deque<T, BLOCK_SIZE>::const_iterator::operator==(const typename Deque<T, BLOCK_SIZE>::const_iterator& other) const {
-    return (blockIndex == other.blockIndex) && (offset == other.offset);
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+bool Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::operator==(const typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator& other) const {
+    return cur == other.cur;
 }
 
 /**************************************************************************************************
- * @brief Inequality comparison for const_iterators.
+ * @brief Inequality comparison for iterators.
  * 
- * Determines if two const_iterators do not point to the same position.
+ * Determines if two iterators point to different positions.
  * 
- * @param other The const_iterator to compare with.
- * @return true if they differ; otherwise, false.
+ * @param other The iterator to compare with.
+ * @return true if the iterators are not equal; otherwise, false.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-bool Deque<T, BLOCK_SIZE>::const_iterator::operator!=(const typename Deque<T, BLOCK_SIZE>::const_iterator& other) const {
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+bool Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::operator!=(const typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator& other) const {
     return !(*this == other);
 }
 
 /**************************************************************************************************
- * @brief Less-than comparison for const_iterators.
+ * @brief Less-than comparison for iterators.
  * 
- * Compares two const_iterators to determine ordering based on block and offset.
+ * Determines if the current iterator precedes another based on map slot and element address.
  * 
- * @param other The const_iterator to compare with.
- * @return true if this const_iterator precedes the other; otherwise, false.
+ * @param other The iterator to compare with.
+ * @return true if this iterator is before other; otherwise, false.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-bool Deque<T, BLOCK_SIZE>::const_iterator::operator<(const typename Deque<T, BLOCK_SIZE>::const_iterator& other) const {
-    return blockIndex < other.blockIndex || (blockIndex == other.blockIndex && offset < other.offset);
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+bool Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::operator<(const typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator& other) const {
+    return node == other.node ? cur < other.cur : node < other.node;
 }
 
 /**************************************************************************************************
- * @brief Greater-than comparison for const_iterators.
+ * @brief Greater-than comparison for iterators.
  * 
- * Checks if this const_iterator comes after the other.
+ * Checks if this iterator comes after the other iterator.
  * 
- * @param other The const_iterator to compare with.
- * @return true if it is greater; otherwise, false.
+ * @param other The iterator to compare with.
+ * @return true if this iterator is after other; otherwise, false.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-bool Deque<T, BLOCK_SIZE>::const_iterator::operator>(const typename Deque<T, BLOCK_SIZE>::const_iterator& other) const {
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+bool Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::operator>(const typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator& other) const {
     return other < *this;
 }
 
 /**************************************************************************************************
- * @brief Less-than-or-equal-to comparison for const_iterators.
+ * @brief Less-than-or-equal-to comparison for iterators.
  * 
- * Determines if this const_iterator is not after the other.
+ * Determines if this iterator is before or at the same position as the other.
  * 
- * @param other The const_iterator to compare with.
- * @return true if it is less than or equal; otherwise, false.
+ * @param other The iterator to compare with.
+ * @return true if this iterator is not after the other; otherwise, false.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-bool Deque<T, BLOCK_SIZE>::const_iterator::operator<=(const typename Deque<T, BLOCK_SIZE>::const_iterator& other) const {
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+bool Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::operator<=(const typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator& other) const {
     return !(other < *this);
 }
 
 /**************************************************************************************************
- * @brief Greater-than-or-equal-to comparison for const_iterators.
+ * @brief Greater-than-or-equal-to comparison for iterators.
  * 
- * Determines if this const_iterator is not before the other.
+ * Determines if this iterator is at the same position or comes after the other.
  * 
- * @param other The const_iterator to compare with.
- * @return true if it is greater than or equal; otherwise, false.
+ * @param other The iterator to compare with.
+ * @return true if this iterator is not before the other; otherwise, false.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-bool Deque<T, BLOCK_SIZE>::const_iterator::operator>=(const typename Deque<T, BLOCK_SIZE>::const_iterator& other) const {
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+bool Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::operator>=(const typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator& other) const {
     return !(*this < other);
 }
 
 /**************************************************************************************************
- * @brief Constructs a Deque object.
- * 
- * Initializes the map with the given initial size, positions the front and back indices 
- * in the middle of the map, and allocates the initial block.
+ * @brief Moves the iterator to another map slot and caches that block's start.
  * 
- * @param initialSize The initial size of the map.
+ * @param n Pointer to the new map slot.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-Deque<T, BLOCK_SIZE>::Deque(size_t initialSize) 
-    : mapSize(initialSize), frontIndex(initialSize/2), backIndex(initialSize/2),
-      frontOffset(0), backOffset(0) {
-    initializeMap(initialSize);
-    allocateBlock(frontIndex);
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator::setNode(T* const* n) {
+    node = n;
+    first = *n;
 }
 
 /**************************************************************************************************
- * @brief Destructor for the Deque.
+ * @brief Constructs an empty Deque that draws its memory from the given allocator.
  * 
- * Deallocates all allocated blocks and deletes the map.
+ * @param allocator The allocator used for blocks and the map.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-Deque<T, BLOCK_SIZE>::~Deque() {
-    if (!empty()) {
-        for (int i = 0; i < mapSize; ++i) {
-            deallocateBlock(i);
-        }
-        delete[] map;
-    }
-}
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+Deque<T, BLOCK_SIZE, Allocator, Stats>::Deque(const Allocator& allocator)
+    : Deque(0, allocator) {}
 
 /**************************************************************************************************
- * @brief Checks if the deque is empty.
+ * @brief Constructs a Deque object.
  * 
- * @return true if there are no elements in the deque; otherwise, false.
+ * Starts from a minimal map with the initial block and then reserves room for initialSize
+ * elements at the back, so the first initialSize push_back() calls do not allocate. If the
+ * reservation throws, the storage allocated so far is released before rethrowing.
+ * 
+ * @param initialSize The initial element capacity.
+ * @param allocator   The allocator used for blocks and the map.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-bool Deque<T, BLOCK_SIZE>::empty() const {
-    return (frontIndex == backIndex) && (frontOffset == backOffset);
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+Deque<T, BLOCK_SIZE, Allocator, Stats>::Deque(size_t initialSize, const Allocator& allocator) 
+    : alloc(allocator), spareBlocks(nullptr), spareCount(0), spareLimit(DEFAULT_SPARE_LIMIT) {
+    initializeStorage(2);
+    try {
+        reserve_back(initialSize);
+    } catch (...) {
+        releaseStorage();
+        throw;
+    }
 }
 
 /**************************************************************************************************
- * @brief Inserts an element at the front of the deque.
+ * @brief Copy constructor.
  * 
- * If the front block is exhausted, a new block is allocated.
- * The element is then placed at the proper position.
+ * Delegates to the sized constructor to reserve room for every element up front, then copies
+ * the source a block at a time with append_range(). Since the delegated constructor has
+ * already completed, an exception from an element copy runs the destructor, which destroys
+ * the copies made so far and releases all storage. The allocator is obtained through
+ * select_on_container_copy_construction().
  * 
- * @param value The element to be inserted.
+ * @param other The deque to copy.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-void Deque<T, BLOCK_SIZE>::push_front(const T& value) {
-    if (!frontOffset) {
-        if (!frontIndex) {
-            growMap(); 
-        }
-        allocateBlock(--frontIndex);
-        frontOffset = BLOCK_SIZE;
-    }
-    map[frontIndex][--frontOffset] = value;
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+Deque<T, BLOCK_SIZE, Allocator, Stats>::Deque(const Deque& other)
+    : Deque(other.size(), AllocTraits::select_on_container_copy_construction(other.alloc)) {
+    set_spare_block_limit(other.spareLimit);
+    other.for_each_segment([this](std::span<const T> segment) { append_range(segment); });
 }
 
 /**************************************************************************************************
- * @brief Inserts an element at the back of the deque.
+ * @brief Move constructor.
  * 
- * If the current back block is full, a new block is allocated.
- * The element is then placed at the back position.
+ * Steals the map, blocks and spare block cache of the source in O(1) without allocating.
+ * The source is left as a valid empty deque without a map; its next insertion or
+ * reservation allocates a fresh minimal one.
  * 
- * @param value The element to be inserted.
+ * @param other The deque to move from.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-void Deque<T, BLOCK_SIZE>::push_back(const T& value) {
-    if (backOffset == BLOCK_SIZE) {
-        if(backIndex == mapSize - 1) {
-            growMap();
-        }
-        allocateBlock(++backIndex);
-        backOffset = 0;
-    }
-    map[backIndex][backOffset++] = value;
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+Deque<T, BLOCK_SIZE, Allocator, Stats>::Deque(Deque&& other) noexcept
+    : alloc(std::move(other.alloc)), spareBlocks(nullptr), spareCount(0), spareLimit(other.spareLimit) {
+    stealStorage(other);
 }
 
 /**************************************************************************************************
- * @brief Access operator for the deque.
- * 
- * Provides random access to elements based on a zero-based index.
- * The internal calculation determines the block and offset.
+ * @brief Destructor for the Deque.
  * 
- * @param index The position of the element.
- * @return Reference to the element at the specified index.
+ * Destroys the live elements, deallocates all allocated blocks, including the ones held in
+ * the spare block cache, and deallocates the map.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-T& Deque<T, BLOCK_SIZE>::operator[](size_t index) {
-    size_t Index = BLOCK_SIZE * frontIndex + frontOffset + index;
-    size_t blockIndex = Index / BLOCK_SIZE;
-    size_t offset = Index % BLOCK_SIZE;
-    return map[blockIndex][offset];
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+Deque<T, BLOCK_SIZE, Allocator, Stats>::~Deque() {
+    releaseStorage();
 }
 
 /**************************************************************************************************
- * @brief Accesses an element with bounds checking.
+ * @brief Copy assignment operator.
  * 
- * Throws a runtime error if the index is out of bounds.
+ * Clears this deque and copy-constructs the elements of the source into the blocks it
+ * already owns. The allocator is replaced only when the allocator propagates on copy
+ * assignment.
  * 
- * @param index The position of the element.
- * @return Reference to the element at the specified index.
+ * @param other The deque to copy.
+ * @return Reference to this deque.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-T& Deque<T, BLOCK_SIZE>::at(size_t index) {
-    if (index < 0 || index >= size()) {
-        throw std::runtime_error("Invalid index.\n");
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+Deque<T, BLOCK_SIZE, Allocator, Stats>& 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::operator=(const Deque& other) {
+    if (this == &other) {
+        return *this;
     }
-    return (*this)[index];
+    if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+        if (alloc != other.alloc) {
+            releaseStorage();
+            alloc = other.alloc;
+            initializeStorage(other.mapSize);
+        }
+    }
+    clear();
+    set_spare_block_limit(other.spareLimit);
+    for (auto it = other.cbegin(); it != other.cend(); ++it) {
+        emplace_back(*it);
+    }
+    return *this;
 }
 
 /**************************************************************************************************
- * @brief Returns the number of elements in the deque.
+ * @brief Move assignment operator.
  * 
- * Computes the size using the difference between the front and back positions.
+ * Steals the storage of the source in O(1) when the allocator propagates on move assignment
+ * or both allocators compare equal; the source is then left without a map, as after the move
+ * constructor, and nothing is allocated. Otherwise the elements are moved one by one into
+ * storage owned by this deque's allocator. The operator is noexcept whenever the allocator
+ * guarantees the first case.
  * 
- * @return The total number of elements.
+ * @param other The deque to move from.
+ * @return Reference to this deque.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-size_t Deque<T, BLOCK_SIZE>::size() const {
-    return (backIndex - frontIndex) * BLOCK_SIZE + (backOffset - frontOffset);
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+Deque<T, BLOCK_SIZE, Allocator, Stats>& 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::operator=(Deque&& other)
+    noexcept(AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) {
+    if (this == &other) {
+        return *this;
+    }
+    if (AllocTraits::propagate_on_container_move_assignment::value || alloc == other.alloc) {
+        releaseStorage();
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+            alloc = std::move(other.alloc);
+        }
+        spareLimit = other.spareLimit;
+        stealStorage(other);
+        return *this;
+    }
+    clear();
+    for (auto it = other.begin(); it != other.end(); ++it) {
+        emplace_back(std::move(*it));
+    }
+    other.clear();
+    return *this;
 }
 
 /**************************************************************************************************
- * @brief Returns an iterator to the beginning of the deque.
- * 
- * The iterator is positioned at the first element.
+ * @brief Returns a copy of the allocator used by the deque.
  * 
- * @return An iterator to the front of the deque.
+ * @return The allocator.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-typename Deque<T, BLOCK_SIZE>::iterator 
-Deque<T, BLOCK_SIZE>::begin() {
-    return Deque<T, BLOCK_SIZE>::iterator(this, frontIndex, frontOffset);
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::allocator_type 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::get_allocator() const {
+    return alloc;
 }
 
 /**************************************************************************************************
- * @brief Returns an iterator to the end of the deque.
+ * @brief Checks if the deque is empty.
+ * 
+ * @return true if there are no elements in the deque; otherwise, false.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+bool Deque<T, BLOCK_SIZE, Allocator, Stats>::empty() const {
+    return (frontIndex == backIndex) && (frontOffset == backOffset);
+}
+
+/**************************************************************************************************
+ * @brief Inserts a copy of an element at the front of the deque.
+ * 
+ * @param value The element to be inserted.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::push_front(const T& value) {
+    emplace_front(value);
+}
+
+/**************************************************************************************************
+ * @brief Moves an element into the front of the deque.
+ * 
+ * @param value The element to be inserted.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::push_front(T&& value) {
+    emplace_front(std::move(value));
+}
+
+/**************************************************************************************************
+ * @brief Inserts a copy of an element at the back of the deque.
+ * 
+ * @param value The element to be inserted.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::push_back(const T& value) {
+    emplace_back(value);
+}
+
+/**************************************************************************************************
+ * @brief Moves an element into the back of the deque.
+ * 
+ * @param value The element to be inserted.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::push_back(T&& value) {
+    emplace_back(std::move(value));
+}
+
+/**************************************************************************************************
+ * @brief Constructs an element in place at the front of the deque.
+ * 
+ * If the front block is exhausted, the previous block is allocated (growing the map if needed)
+ * before the element is constructed. Should the constructor throw, that block is released
+ * again and the deque is left unchanged.
+ * 
+ * @param args Arguments forwarded to the element's constructor.
+ * @return Reference to the new first element.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+template <typename... Args>
+T& Deque<T, BLOCK_SIZE, Allocator, Stats>::emplace_front(Args&&... args) {
+    ensureStorage();
+    if (!frontOffset) {
+        reserveMapFront(1);
+        if (reservedFront) {
+            --reservedFront;
+        }
+        allocateBlock(frontIndex - 1);
+        try {
+            AllocTraits::construct(alloc, map[frontIndex - 1] + BLOCK_SIZE - 1, std::forward<Args>(args)...);
+        } catch (...) {
+            deallocateBlock(frontIndex - 1);
+            throw;
+        }
+        --frontIndex;
+        frontOffset = BLOCK_SIZE - 1;
+        recordPeak();
+        return map[frontIndex][frontOffset];
+    }
+    AllocTraits::construct(alloc, map[frontIndex] + frontOffset - 1, std::forward<Args>(args)...);
+    --frontOffset;
+    recordPeak();
+    return map[frontIndex][frontOffset];
+}
+
+/**************************************************************************************************
+ * @brief Constructs an element in place at the back of the deque.
+ * 
+ * The back position always lies inside an allocated block. When the element fills the last
+ * slot of that block, the next block is allocated first (growing the map if needed), so the
+ * back position can move on to it. Should the constructor throw, that block is released
+ * again and the deque is left unchanged.
+ * 
+ * @param args Arguments forwarded to the element's constructor.
+ * @return Reference to the new last element.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+template <typename... Args>
+T& Deque<T, BLOCK_SIZE, Allocator, Stats>::emplace_back(Args&&... args) {
+    ensureStorage();
+    if (backOffset == BLOCK_SIZE - 1) {
+        reserveMapBack(1);
+        if (reservedBack) {
+            --reservedBack;
+        }
+        allocateBlock(backIndex + 1);
+        try {
+            AllocTraits::construct(alloc, map[backIndex] + backOffset, std::forward<Args>(args)...);
+        } catch (...) {
+            deallocateBlock(backIndex + 1);
+            throw;
+        }
+        ++backIndex;
+        backOffset = 0;
+        recordPeak();
+        return map[backIndex - 1][BLOCK_SIZE - 1];
+    }
+    AllocTraits::construct(alloc, map[backIndex] + backOffset, std::forward<Args>(args)...);
+    ++backOffset;
+    recordPeak();
+    return map[backIndex][backOffset - 1];
+}
+
+/**************************************************************************************************
+ * @brief Removes the element at the front of the deque.
+ * 
+ * Destroys the element in place. When the front block becomes empty it is handed back to
+ * the spare block cache.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::pop_front() {
+    if (empty()) {
+        throw std::runtime_error("Deque is empty.\n");
+    }
+    AllocTraits::destroy(alloc, map[frontIndex] + frontOffset);
+    if (++frontOffset == BLOCK_SIZE) {
+        deallocateBlock(frontIndex++);
+        frontOffset = 0;
+    }
+}
+
+/**************************************************************************************************
+ * @brief Removes the element at the back of the deque.
+ * 
+ * When the back position leaves a block, that block is handed back to the spare block cache.
+ * The element is then destroyed in place.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::pop_back() {
+    if (empty()) {
+        throw std::runtime_error("Deque is empty.\n");
+    }
+    if (!backOffset) {
+        deallocateBlock(backIndex--);
+        backOffset = BLOCK_SIZE;
+    }
+    AllocTraits::destroy(alloc, map[backIndex] + --backOffset);
+}
+
+/**************************************************************************************************
+ * @brief Accesses the first element.
+ * 
+ * Throws a runtime error if the deque is empty.
+ * 
+ * @return Reference to the first element.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+T& Deque<T, BLOCK_SIZE, Allocator, Stats>::front() {
+    if (empty()) {
+        throw std::runtime_error("Deque is empty.\n");
+    }
+    return map[frontIndex][frontOffset];
+}
+
+/**************************************************************************************************
+ * @brief Accesses the first element of a constant deque.
+ * 
+ * @return Constant reference to the first element.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+const T& Deque<T, BLOCK_SIZE, Allocator, Stats>::front() const {
+    if (empty()) {
+        throw std::runtime_error("Deque is empty.\n");
+    }
+    return map[frontIndex][frontOffset];
+}
+
+/**************************************************************************************************
+ * @brief Accesses the last element.
+ * 
+ * Throws a runtime error if the deque is empty.
+ * 
+ * @return Reference to the last element.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+T& Deque<T, BLOCK_SIZE, Allocator, Stats>::back() {
+    if (empty()) {
+        throw std::runtime_error("Deque is empty.\n");
+    }
+    return backOffset ? map[backIndex][backOffset - 1] : map[backIndex - 1][BLOCK_SIZE - 1];
+}
+
+/**************************************************************************************************
+ * @brief Accesses the last element of a constant deque.
+ * 
+ * @return Constant reference to the last element.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+const T& Deque<T, BLOCK_SIZE, Allocator, Stats>::back() const {
+    if (empty()) {
+        throw std::runtime_error("Deque is empty.\n");
+    }
+    return backOffset ? map[backIndex][backOffset - 1] : map[backIndex - 1][BLOCK_SIZE - 1];
+}
+
+/**************************************************************************************************
+ * @brief Removes all elements from the deque.
+ * 
+ * Destroys every element, hands every block except the front one back to the spare block
+ * cache, and moves the front block to the middle of the map slots left free by any
+ * outstanding reservations, where the front and back positions restart. The map itself
+ * keeps its size. Nothing is allocated, so clear() cannot throw.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::clear() {
+    if (map == nullptr) {
+        return;
+    }
+    destroyElements();
+    T* block = map[frontIndex];
+    map[frontIndex] = nullptr;
+    for (size_t i = frontIndex + 1; i <= backIndex; ++i) {
+        deallocateBlock(i);
+    }
+    frontIndex = backIndex = reservedFront + (mapSize - reservedFront - reservedBack - 1) / 2;
+    frontOffset = backOffset = 0;
+    map[frontIndex] = block;
+}
+
+/**************************************************************************************************
+ * @brief Appends the elements of a range at the back of the deque.
+ * 
+ * Sized and forward ranges are copied a block at a time: each step fills the free part of
+ * the back block in one go, using memcpy when T is trivially copyable and the range is
+ * contiguous. Other input ranges fall back to one emplace_back() per element. If an element
+ * constructor throws, the elements appended before it are kept.
+ * 
+ * @param range The range to append.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+template <std::ranges::input_range R>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::append_range(R&& range) {
+    if constexpr (std::ranges::forward_range<R> || std::ranges::sized_range<R>) {
+        auto first = std::ranges::begin(range);
+        size_t remaining = static_cast<size_t>(std::ranges::distance(range));
+        ensureStorage();
+        while (remaining) {
+            size_t count = BLOCK_SIZE - backOffset;
+            if (count > remaining) {
+                count = remaining;
+            }
+            bool fillsBlock = (backOffset + count == BLOCK_SIZE);
+            if (fillsBlock) {
+                reserveMapBack(1);
+                if (reservedBack) {
+                    --reservedBack;
+                }
+                allocateBlock(backIndex + 1);
+            }
+            try {
+                first = constructRange(std::move(first), map[backIndex] + backOffset, count);
+            } catch (...) {
+                if (fillsBlock) {
+                    deallocateBlock(backIndex + 1);
+                }
+                throw;
+            }
+            remaining -= count;
+            if (fillsBlock) {
+                ++backIndex;
+                backOffset = 0;
+            } else {
+                backOffset += count;
+            }
+        }
+        recordPeak();
+    } else {
+        for (auto&& value : range) {
+            emplace_back(std::forward<decltype(value)>(value));
+        }
+    }
+}
+
+/**************************************************************************************************
+ * @brief Inserts the elements of a range at the front of the deque, keeping their order.
+ * 
+ * For sized and forward ranges, every block needed in front of the current first element is
+ * allocated up front and the elements are then copied forward a block at a time, like
+ * append_range(). Other input ranges are pushed one by one and the inserted prefix is
+ * reversed afterwards. In both cases, if an allocation or an element constructor throws, the
+ * elements already inserted are removed and the deque is left unchanged, reservations
+ * included.
+ * 
+ * @param range The range to prepend.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+template <std::ranges::input_range R>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::prepend_range(R&& range) {
+    if constexpr (std::ranges::forward_range<R> || std::ranges::sized_range<R>) {
+        auto first = std::ranges::begin(range);
+        size_t count = static_cast<size_t>(std::ranges::distance(range));
+        if (!count) {
+            return;
+        }
+        ensureStorage();
+
+        size_t newBlocks = count > frontOffset ? (count - frontOffset + BLOCK_SIZE - 1) / BLOCK_SIZE : 0;
+        reserveMapFront(newBlocks);
+        size_t reserved = reservedFront;
+        size_t placed = 0;
+        size_t start = slotsIn(frontIndex) + frontOffset - count;
+        size_t position = start;
+        try {
+            while (placed != newBlocks) {
+                if (reservedFront) {
+                    --reservedFront;
+                }
+                allocateBlock(frontIndex - placed - 1);
+                ++placed;
+            }
+            while (position != start + count) {
+                size_t chunk = BLOCK_SIZE - offsetOf(position);
+                if (chunk > start + count - position) {
+                    chunk = start + count - position;
+                }
+                first = constructRange(std::move(first), map[blockOf(position)] + offsetOf(position), chunk);
+                position += chunk;
+            }
+        } catch (...) {
+            for (size_t i = start; i != position; ++i) {
+                AllocTraits::destroy(alloc, map[blockOf(i)] + offsetOf(i));
+            }
+            reservedFront = reserved;
+            for (size_t i = 1; i <= placed; ++i) {
+                deallocateBlock(frontIndex - i);
+            }
+            throw;
+        }
+        frontIndex = blockOf(start);
+        frontOffset = offsetOf(start);
+        recordPeak();
+    } else {
+        size_t reserved = reservedFront;
+        size_t count = 0;
+        try {
+            for (auto&& value : range) {
+                emplace_front(std::forward<decltype(value)>(value));
+                ++count;
+            }
+        } catch (...) {
+            while (count--) {
+                pop_front();
+            }
+            reservedFront = reserved;
+            throw;
+        }
+        std::reverse(begin(), begin() + count);
+    }
+}
+
+/**************************************************************************************************
+ * @brief Replaces the contents of the deque with the elements of a range.
+ * 
+ * @param range The range to copy from.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+template <std::ranges::input_range R>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::assign(R&& range) {
+    clear();
+    append_range(std::forward<R>(range));
+}
+
+/**************************************************************************************************
+ * @brief Calls a function once per contiguous run of elements.
+ * 
+ * Each run covers the live part of one block and is passed as a std::span<T>, in order from
+ * front to back. Loops over a span have no block-boundary checks, so the compiler can
+ * vectorize them.
+ * 
+ * @param f Function invoked with a std::span<T> for every non-empty block.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+template <typename F>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::for_each_segment(F&& f) {
+    for (size_t i = frontIndex; i <= backIndex; ++i) {
+        size_t first = (i == frontIndex) ? frontOffset : 0;
+        size_t last = (i == backIndex) ? backOffset : BLOCK_SIZE;
+        if (first < last) {
+            f(std::span<T>(map[i] + first, last - first));
+        }
+    }
+}
+
+/**************************************************************************************************
+ * @brief Calls a function once per contiguous run of elements of a constant deque.
+ * 
+ * @param f Function invoked with a std::span<const T> for every non-empty block.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+template <typename F>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::for_each_segment(F&& f) const {
+    for (size_t i = frontIndex; i <= backIndex; ++i) {
+        size_t first = (i == frontIndex) ? frontOffset : 0;
+        size_t last = (i == backIndex) ? backOffset : BLOCK_SIZE;
+        if (first < last) {
+            f(std::span<const T>(map[i] + first, last - first));
+        }
+    }
+}
+
+/**************************************************************************************************
+ * @brief Copies every element, in order, into a contiguous buffer.
+ * 
+ * Copies one block at a time, with memcpy when T is trivially copyable.
+ * 
+ * @param dest Start of a buffer with room for size() elements.
+ * @return Pointer one past the last element written.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+T* Deque<T, BLOCK_SIZE, Allocator, Stats>::copy_out(T* dest) const {
+    for_each_segment([&dest](std::span<const T> segment) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::memcpy(dest, segment.data(), segment.size_bytes());
+            dest += segment.size();
+        } else {
+            dest = std::copy(segment.begin(), segment.end(), dest);
+        }
+    });
+    return dest;
+}
+
+/**************************************************************************************************
+ * @brief Writes the deque to a binary snapshot file.
+ * 
+ * Writes a DequeSnapshotHeader followed by every block from front to back, exactly as laid
+ * out in memory. The blocks are streamed one at a time, so no copy of the contents is made.
+ * The snapshot can be read back with load() or mapped with MappedDeque.
+ * 
+ * @param path The file to create or overwrite.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::save(const std::filesystem::path& path) const
+    requires std::is_trivially_copyable_v<T> {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot open snapshot file.\n");
+    }
+
+    DequeSnapshotHeader header = DequeSnapshotHeader::describe<T, BLOCK_SIZE>(size(), frontOffset);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writePadding(out, header.headerBytes - sizeof(header));
+    for (size_t i = frontIndex; i <= backIndex; ++i) {
+        size_t first = (i == frontIndex) ? frontOffset : 0;
+        size_t last = (i == backIndex) ? backOffset : BLOCK_SIZE;
+        writePadding(out, first * sizeof(T));
+        if (first < last) {
+            out.write(reinterpret_cast<const char*>(map[i] + first), static_cast<std::streamsize>((last - first) * sizeof(T)));
+        }
+        writePadding(out, (BLOCK_SIZE - last) * sizeof(T));
+    }
+
+    out.flush();
+    if (!out) {
+        throw std::runtime_error("Failed to write snapshot file.\n");
+    }
+}
+
+/**************************************************************************************************
+ * @brief Replaces the contents of the deque with a snapshot written by save().
+ * 
+ * Each block is read straight from the file into a freshly allocated block, keeping the
+ * layout of the saved deque. The snapshot must have been written for the same element size,
+ * alignment and BLOCK_SIZE; otherwise, or if the file is truncated, a std::runtime_error is
+ * thrown and the deque is left unchanged. The blocks are built under a copy of the statistics
+ * policy with fresh counters, which are added to this deque's once loading ends.
+ * 
+ * @param path The snapshot file to read.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::load(const std::filesystem::path& path)
+    requires std::is_trivially_copyable_v<T> {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open snapshot file.\n");
+    }
+
+    DequeSnapshotHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        throw std::runtime_error("Snapshot is corrupt or truncated.\n");
+    }
+    header.validate<T, BLOCK_SIZE>(std::filesystem::file_size(path));
+    in.seekg(header.headerBytes);
+
+    Deque loaded(alloc);
+    Stats policy = statsPolicy;
+    policy.reset();
+    policy.merge(loaded.statsPolicy);
+    loaded.statsPolicy = std::move(policy);
+    try {
+        loaded.set_spare_block_limit(spareLimit);
+        loaded.reserveMapBack(header.blocks - 1);
+        for (size_t i = 0; i < header.blocks; ++i) {
+            loaded.allocateBlock(loaded.frontIndex + i);
+            if (!in.read(reinterpret_cast<char*>(loaded.map[loaded.frontIndex + i]), BLOCK_SIZE * sizeof(T))) {
+                throw std::runtime_error("Snapshot is corrupt or truncated.\n");
+            }
+        }
+    } catch (...) {
+        loaded.releaseStorage();
+        statsPolicy.merge(loaded.statsPolicy);
+        throw;
+    }
+    loaded.frontOffset = header.frontOffset;
+    loaded.backIndex = loaded.frontIndex + header.blocks - 1;
+    loaded.backOffset = (header.frontOffset + header.size) - (header.blocks - 1) * BLOCK_SIZE;
+    loaded.recordPeak();
+    *this = std::move(loaded);
+    statsPolicy.merge(loaded.statsPolicy);
+}
+
+/**************************************************************************************************
+ * @brief Releases memory that is not needed to hold the current elements.
+ * 
+ * Drops any outstanding reservations, frees every block in the spare block cache and trims
+ * the map down to the slots that currently hold blocks. The next push at either end grows
+ * the map again.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::shrink_to_fit() {
+    if (map == nullptr) {
+        return;
+    }
+    reservedFront = reservedBack = 0;
+    releaseSpareBlocks();
+    resizeSpareCache(spareLimit);
+
+    size_t newMapSize = backIndex - frontIndex + 1;
+    if (newMapSize < 2) {
+        newMapSize = 2;
+    }
+    if (newMapSize >= mapSize) {
+        return;
+    }
+
+    T** newMap = allocateMap(newMapSize);
+    for (size_t i = 0; i < newMapSize; ++i) {
+        newMap[i] = nullptr;
+    }
+    for (size_t i = frontIndex; i <= backIndex; ++i) {
+        newMap[i - frontIndex] = map[i];
+    }
+
+    deallocateMap(map, mapSize);
+    map = newMap;
+    mapSize = newMapSize;
+    backIndex -= frontIndex;
+    frontIndex = 0;
+}
+
+/**************************************************************************************************
+ * @brief Returns the maximum number of blocks kept in the spare block cache.
+ * 
+ * @return The spare block cache limit.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+size_t Deque<T, BLOCK_SIZE, Allocator, Stats>::spare_block_limit() const {
+    return spareLimit;
+}
+
+/**************************************************************************************************
+ * @brief Sets the maximum number of blocks kept in the spare block cache.
+ * 
+ * Blocks that no longer fit under the new limit are freed immediately, except those held
+ * for reserve_front()/reserve_back(). A limit of zero disables the cache, so every emptied
+ * block goes straight back to the allocator.
+ * 
+ * @param limit The new spare block cache limit.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::set_spare_block_limit(size_t limit) {
+    spareLimit = limit;
+    if (map == nullptr) {
+        return;
+    }
+    size_t capacity = std::max(limit, reservedFront + reservedBack);
+    while (spareCount > capacity) {
+        freeBlock(spareBlocks[--spareCount]);
+    }
+    resizeSpareCache(capacity);
+}
+
+/**************************************************************************************************
+ * @brief Reserves room for n more elements at the back of the deque.
+ * 
+ * Makes sure the map has enough free slots after the back block and that the spare block
+ * cache holds the blocks those elements will need, so the next n push_back() or
+ * emplace_back() calls never allocate or grow the map. Pushes at the front and
+ * shrink_to_fit() do not consume this reservation, but shrink_to_fit() drops it.
+ * 
+ * @param n The number of elements to reserve room for.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::reserve_back(size_t n) {
+    ensureStorage();
+    reservedBack = std::max(reservedBack, blockOf(backOffset + n));
+    reserveMapBack(reservedBack);
+    reserveSpareBlocks();
+}
+
+/**************************************************************************************************
+ * @brief Reserves room for n more elements at the front of the deque.
+ * 
+ * The front counterpart of reserve_back(): the next n push_front() or emplace_front() calls
+ * never allocate or grow the map.
+ * 
+ * @param n The number of elements to reserve room for.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::reserve_front(size_t n) {
+    ensureStorage();
+    size_t blocks = n > frontOffset ? (n - frontOffset + BLOCK_SIZE - 1) / BLOCK_SIZE : 0;
+    reservedFront = std::max(reservedFront, blocks);
+    reserveMapFront(reservedFront);
+    reserveSpareBlocks();
+}
+
+/**************************************************************************************************
+ * @brief Returns the number of blocks currently held in the spare block cache.
+ * 
+ * @return The number of cached blocks.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+size_t Deque<T, BLOCK_SIZE, Allocator, Stats>::spare_blocks() const {
+    return spareCount;
+}
+
+/**************************************************************************************************
+ * @brief Returns the storage statistics of the deque.
+ * 
+ * The counters come from the Stats policy and stay zero with the default NoDequeStats; the
+ * current size, blocks in use, map slots and cached blocks are always filled in. Statistics
+ * belong to this object: copies and moves start their own.
+ * 
+ * @return A snapshot of the statistics.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+DequeStatsSnapshot Deque<T, BLOCK_SIZE, Allocator, Stats>::stats() const {
+    DequeStatsSnapshot snapshot = statsPolicy.snapshot();
+    snapshot.size = size();
+    snapshot.blocksInUse = map == nullptr ? 0 : backIndex - frontIndex + 1;
+    snapshot.mapSlots = mapSize;
+    snapshot.spareBlocks = spareCount;
+    return snapshot;
+}
+
+/**************************************************************************************************
+ * @brief Resets the cumulative statistics counters to zero.
+ * 
+ * The peaks restart from the current size and number of blocks in use.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::reset_stats() {
+    statsPolicy.reset();
+    recordPeak();
+}
+
+/**************************************************************************************************
+ * @brief Gives access to the statistics policy, e.g. to install a growth hook.
+ * 
+ * @return Reference to the policy object.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+Stats& Deque<T, BLOCK_SIZE, Allocator, Stats>::stats_policy() {
+    return statsPolicy;
+}
+
+/**************************************************************************************************
+ * @brief Access operator for the deque.
+ * 
+ * Provides random access to elements based on a zero-based index.
+ * The internal calculation determines the block and offset with shifts and masks when
+ * BLOCK_SIZE is a power of two.
+ * 
+ * @param index The position of the element.
+ * @return Reference to the element at the specified index.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+T& Deque<T, BLOCK_SIZE, Allocator, Stats>::operator[](size_t index) {
+    size_t Index = slotsIn(frontIndex) + frontOffset + index;
+    return map[blockOf(Index)][offsetOf(Index)];
+}
+
+/**************************************************************************************************
+ * @brief Accesses an element with bounds checking.
+ * 
+ * Throws a runtime error if the index is out of bounds.
+ * 
+ * @param index The position of the element.
+ * @return Reference to the element at the specified index.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+T& Deque<T, BLOCK_SIZE, Allocator, Stats>::at(size_t index) {
+    if (index < 0 || index >= size()) {
+        throw std::runtime_error("Invalid index.\n");
+    }
+    return (*this)[index];
+}
+
+/**************************************************************************************************
+ * @brief Returns the number of elements in the deque.
+ * 
+ * Computes the size using the difference between the front and back positions.
+ * 
+ * @return The total number of elements.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+size_t Deque<T, BLOCK_SIZE, Allocator, Stats>::size() const {
+    return slotsIn(backIndex - frontIndex) + (backOffset - frontOffset);
+}
+
+/**************************************************************************************************
+ * @brief Returns an iterator to the beginning of the deque.
+ * 
+ * The iterator is positioned at the first element.
+ * 
+ * @return An iterator to the front of the deque.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::begin() {
+    if (map == nullptr) {
+        return iterator();
+    }
+    return iterator(map + frontIndex, map[frontIndex] + frontOffset);
+}
+
+/**************************************************************************************************
+ * @brief Returns an iterator to the end of the deque.
  * 
  * The iterator is positioned one element past the last valid element.
  * 
  * @return An iterator to the end of the deque.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-typename Deque<T, BLOCK_SIZE>::iterator 
-Deque<T, BLOCK_SIZE>::end() {
-    return Deque<T, BLOCK_SIZE>::iterator(this, backIndex, backOffset);
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::end() {
+    if (map == nullptr) {
+        return iterator();
+    }
+    return iterator(map + backIndex, map[backIndex] + backOffset);
 }
 
 /**************************************************************************************************
@@ -636,10 +1687,13 @@ Deque<T, BLOCK_SIZE>::end() {
  * 
  * @return A const_iterator to the first element.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-typename Deque<T, BLOCK_SIZE>::const_iterator 
-Deque<T, BLOCK_SIZE>::cbegin() const { 
-    return typename Deque<T, BLOCK_SIZE>::const_iterator(this, frontIndex, frontOffset); 
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::cbegin() const { 
+    if (map == nullptr) {
+        return const_iterator();
+    }
+    return const_iterator(map + frontIndex, map[frontIndex] + frontOffset);
 }
 
 /**************************************************************************************************
@@ -647,10 +1701,230 @@ Deque<T, BLOCK_SIZE>::cbegin() const {
  * 
  * @return A const_iterator one past the last element.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-typename Deque<T, BLOCK_SIZE>::const_iterator 
-Deque<T, BLOCK_SIZE>::cend() const { 
-    return typename Deque<T, BLOCK_SIZE>::const_iterator(this, backIndex, backOffset); 
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::const_iterator 
+Deque<T, BLOCK_SIZE, Allocator, Stats>::cend() const { 
+    if (map == nullptr) {
+        return const_iterator();
+    }
+    return const_iterator(map + backIndex, map[backIndex] + backOffset);
+}
+
+/**************************************************************************************************
+ * @brief Returns the block index of a linear slot position.
+ * 
+ * Uses a shift when BLOCK_SIZE is a power of two and falls back to division otherwise.
+ * 
+ * @param position The linear slot position (block index * BLOCK_SIZE + offset).
+ * @return The block index containing the position.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+constexpr size_t Deque<T, BLOCK_SIZE, Allocator, Stats>::blockOf(size_t position) {
+    if constexpr (BLOCK_IS_POWER_OF_TWO) {
+        return position >> BLOCK_SHIFT;
+    } else {
+        return position / BLOCK_SIZE;
+    }
+}
+
+/**************************************************************************************************
+ * @brief Returns the offset within its block of a linear slot position.
+ * 
+ * Uses a mask when BLOCK_SIZE is a power of two and falls back to modulo otherwise.
+ * 
+ * @param position The linear slot position (block index * BLOCK_SIZE + offset).
+ * @return The offset of the position within its block.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+constexpr size_t Deque<T, BLOCK_SIZE, Allocator, Stats>::offsetOf(size_t position) {
+    if constexpr (BLOCK_IS_POWER_OF_TWO) {
+        return position & BLOCK_MASK;
+    } else {
+        return position % BLOCK_SIZE;
+    }
+}
+
+/**************************************************************************************************
+ * @brief Returns the number of slots spanned by a number of blocks.
+ * 
+ * @param blocks The number of blocks.
+ * @return blocks * BLOCK_SIZE, computed with a shift when BLOCK_SIZE is a power of two.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+constexpr size_t Deque<T, BLOCK_SIZE, Allocator, Stats>::slotsIn(size_t blocks) {
+    if constexpr (BLOCK_IS_POWER_OF_TWO) {
+        return blocks << BLOCK_SHIFT;
+    } else {
+        return blocks * BLOCK_SIZE;
+    }
+}
+
+/**************************************************************************************************
+ * @brief Sets up an empty deque around a freshly allocated map.
+ * 
+ * Allocates the map and the spare block cache, positions the front and back indices in the
+ * middle of the map and allocates the initial block. If an allocation throws, whatever was
+ * allocated is released again and the deque is left without a map.
+ * 
+ * @param size The requested number of map slots (at least two are used).
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::initializeStorage(size_t size) {
+    resetStorage();
+    try {
+        spareBlocks = allocateMap(spareLimit);
+        spareCapacity = spareLimit;
+        initializeMap(size < 2 ? 2 : size);
+        mapSize = size < 2 ? 2 : size;
+        frontIndex = backIndex = mapSize / 2;
+        allocateBlock(frontIndex);
+    } catch (...) {
+        releaseStorage();
+        throw;
+    }
+    recordPeak();
+}
+
+/**************************************************************************************************
+ * @brief Gives a deque left without a map by a move its minimal map back.
+ * 
+ * Called before every operation that needs a block to write into.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::ensureStorage() {
+    if (map == nullptr) {
+        initializeStorage(2);
+    }
+}
+
+/**************************************************************************************************
+ * @brief Destroys all elements and returns every block and the map to the allocator.
+ * 
+ * Leaves the deque empty and without a map, the same state a move leaves its source in.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::releaseStorage() {
+    destroyElements();
+    for (size_t i = 0; i < mapSize; ++i) {
+        if (map[i] != nullptr) {
+            freeBlock(map[i]);
+        }
+    }
+    releaseSpareBlocks();
+    deallocateMap(spareBlocks, spareCapacity);
+    deallocateMap(map, mapSize);
+    resetStorage();
+}
+
+/**************************************************************************************************
+ * @brief Puts the deque into the empty state without a map, without freeing anything.
+ * 
+ * In that state there are no blocks, no spare block cache and no reservations; size() is
+ * zero and begin() equals end(). The spare block limit is kept.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::resetStorage() noexcept {
+    map = nullptr;
+    mapSize = 0;
+    frontIndex = backIndex = 0;
+    frontOffset = backOffset = 0;
+    spareBlocks = nullptr;
+    spareCount = spareCapacity = 0;
+    reservedFront = reservedBack = 0;
+}
+
+/**************************************************************************************************
+ * @brief Destroys every live element in place.
+ * 
+ * Does nothing for trivially destructible element types. Blocks stay allocated.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::destroyElements() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+        for_each_segment([this](std::span<T> segment) {
+            for (T& value : segment) {
+                AllocTraits::destroy(alloc, &value);
+            }
+        });
+    }
+}
+
+/**************************************************************************************************
+ * @brief Constructs a run of elements in raw block storage from an iterator.
+ * 
+ * Uses a single memcpy when T is trivially copyable and the iterator is contiguous over T;
+ * otherwise constructs the elements one by one through the allocator. If a constructor
+ * throws, the elements already built by this call are destroyed before rethrowing.
+ * 
+ * @param first Iterator to the first source element.
+ * @param dest  Raw storage for count elements.
+ * @param count Number of elements to construct.
+ * @return Iterator one past the last source element consumed.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+template <typename It>
+It Deque<T, BLOCK_SIZE, Allocator, Stats>::constructRange(It first, T* dest, size_t count) {
+    if constexpr (std::is_trivially_copyable_v<T> && std::contiguous_iterator<It> &&
+                  std::is_same_v<std::iter_value_t<It>, T>) {
+        std::memcpy(dest, std::to_address(first), count * sizeof(T));
+        return first + count;
+    } else {
+        size_t i = 0;
+        try {
+            for (; i < count; ++i, ++first) {
+                AllocTraits::construct(alloc, dest + i, *first);
+            }
+        } catch (...) {
+            while (i) {
+                AllocTraits::destroy(alloc, dest + --i);
+            }
+            throw;
+        }
+        return first;
+    }
+}
+
+/**************************************************************************************************
+ * @brief Takes over the map, blocks and spare block cache of another deque.
+ * 
+ * The other deque is left empty and without a map; nothing is allocated. This deque's own
+ * storage must already have been released.
+ * 
+ * @param other The deque to steal from.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::stealStorage(Deque& other) noexcept {
+    map = other.map;
+    mapSize = other.mapSize;
+    frontIndex = other.frontIndex;
+    backIndex = other.backIndex;
+    frontOffset = other.frontOffset;
+    backOffset = other.backOffset;
+    spareBlocks = other.spareBlocks;
+    spareCount = other.spareCount;
+    spareCapacity = other.spareCapacity;
+    reservedFront = other.reservedFront;
+    reservedBack = other.reservedBack;
+    other.resetStorage();
+}
+
+/**************************************************************************************************
+ * @brief Writes a run of zero bytes to a stream.
+ * 
+ * Used for the unused slots at both ends of a snapshot, so no uninitialized memory is
+ * written to the file.
+ * 
+ * @param out   The stream to write to.
+ * @param bytes The number of zero bytes.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::writePadding(std::ostream& out, size_t bytes) {
+    static constexpr char zeros[4096] = {};
+    while (bytes) {
+        size_t chunk = std::min(bytes, sizeof(zeros));
+        out.write(zeros, static_cast<std::streamsize>(chunk));
+        bytes -= chunk;
+    }
 }
 
 /**************************************************************************************************
@@ -660,64 +1934,247 @@ Deque<T, BLOCK_SIZE>::cend() const {
  * 
  * @param size The number of block pointers to allocate.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-void Deque<T, BLOCK_SIZE>::initializeMap(size_t size) {
-    map = new T*[size];
-    for (int i = 0; i < size; ++i) {
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::initializeMap(size_t size) {
+    map = allocateMap(size);
+    for (size_t i = 0; i < size; ++i) {
         map[i] = nullptr;
     }
 }
 
+/**************************************************************************************************
+ * @brief Allocates an array of block pointers through the rebound allocator.
+ * 
+ * @param size The number of block pointers.
+ * @return The uninitialized array, or nullptr if size is zero.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+T** Deque<T, BLOCK_SIZE, Allocator, Stats>::allocateMap(size_t size) {
+    if (!size) {
+        return nullptr;
+    }
+    MapAllocator mapAlloc(alloc);
+    return MapAllocTraits::allocate(mapAlloc, size);
+}
+
+/**************************************************************************************************
+ * @brief Returns an array of block pointers to the rebound allocator.
+ * 
+ * @param array The array to deallocate (may be nullptr).
+ * @param size  The number of block pointers it was allocated with.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::deallocateMap(T** array, size_t size) {
+    if (array != nullptr) {
+        MapAllocator mapAlloc(alloc);
+        MapAllocTraits::deallocate(mapAlloc, array, size);
+    }
+}
+
+/**************************************************************************************************
+ * @brief Requests one block of raw storage from the allocator.
+ * 
+ * @return The new block.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+T* Deque<T, BLOCK_SIZE, Allocator, Stats>::newBlock() {
+    T* block = AllocTraits::allocate(alloc, BLOCK_SIZE);
+    statsPolicy.on_block_allocated();
+    return block;
+}
+
+/**************************************************************************************************
+ * @brief Returns one block of raw storage to the allocator.
+ * 
+ * @param block The block to free; it must not hold any live elements.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::freeBlock(T* block) {
+    AllocTraits::deallocate(alloc, block, BLOCK_SIZE);
+    statsPolicy.on_block_freed();
+}
+
 /**************************************************************************************************
  * @brief Allocates a block at a given index.
  * 
- * Checks if the block pointer is nullptr and, if so, allocates a new block.
+ * Checks if the block pointer is nullptr and, if so, takes a block from the spare block
+ * cache. Blocks held for outstanding reservations are left alone; callers consuming a
+ * reservation release it before calling. Only when no free cached block is left is a new
+ * block requested from the allocator. Blocks are raw storage: elements are constructed in
+ * them one at a time as they are inserted.
  * 
  * @param index The index in the map where the block should be allocated.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-void Deque<T, BLOCK_SIZE>::allocateBlock(size_t index) {
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::allocateBlock(size_t index) {
+    statsPolicy.on_allocate_block();
     if (map[index] == nullptr) {
-        map[index] = new T[BLOCK_SIZE];
+        if (spareCount > reservedFront + reservedBack) {
+            map[index] = spareBlocks[--spareCount];
+        } else {
+            map[index] = newBlock();
+        }
     }
 }
 
 /**************************************************************************************************
  * @brief Deallocates a block at a given index.
  * 
- * Deletes the allocated block if it exists.
+ * Moves the block into the spare block cache if there is room for it; otherwise the block
+ * is returned to the allocator. The map slot is reset to nullptr in both cases. The block
+ * must not hold any live elements.
  * 
  * @param index The index in the map of the block to deallocate.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-void Deque<T, BLOCK_SIZE>::deallocateBlock(size_t index) {
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::deallocateBlock(size_t index) {
+    statsPolicy.on_deallocate_block();
     if (map[index] != nullptr) {
-        delete [] map[index];
+        if (spareCount < spareLimit) {
+            spareBlocks[spareCount++] = map[index];
+        } else {
+            freeBlock(map[index]);
+        }
+        map[index] = nullptr;
     }
 }
 
 /**************************************************************************************************
- * @brief Expands the internal map when more blocks are needed.
+ * @brief Reports the current size and number of blocks in use to the statistics policy.
  * 
- * Doubles the map size, copies the existing blocks to the new map with an offset,
- * and initializes the new areas to nullptr.
+ * Compiled out entirely when the policy is disabled, so the push paths pay nothing for it.
  **************************************************************************************************/
-template <typename T, size_t BLOCK_SIZE>
-void Deque<T, BLOCK_SIZE>::growMap() {
-    size_t newMapSize = mapSize * 2;
-    T** newMap = new T*[newMapSize];
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::recordPeak() {
+    if constexpr (Stats::enabled) {
+        statsPolicy.on_size(size(), map == nullptr ? 0 : backIndex - frontIndex + 1);
+    }
+}
 
-    size_t offset = mapSize / 2;
-    for (size_t i = 0; i < mapSize; ++i) {
-        newMap[i + offset] = map[i];
+/**************************************************************************************************
+ * @brief Frees every block held in the spare block cache.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::releaseSpareBlocks() {
+    while (spareCount) {
+        freeBlock(spareBlocks[--spareCount]);
     }
+}
 
-    for (size_t i = 0; i < offset; ++i) {
-        newMap[i] = nullptr;
-        newMap[i + mapSize] = nullptr;
+/**************************************************************************************************
+ * @brief Resizes the array backing the spare block cache.
+ * 
+ * @param capacity The new number of slots; must be at least the number of cached blocks.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::resizeSpareCache(size_t capacity) {
+    if (capacity == spareCapacity) {
+        return;
     }
 
-    delete[] map;
-    map = newMap;
-    mapSize = newMapSize;
+    T** newSpareBlocks = allocateMap(capacity);
+    for (size_t i = 0; i < spareCount; ++i) {
+        newSpareBlocks[i] = spareBlocks[i];
+    }
+
+    deallocateMap(spareBlocks, spareCapacity);
+    spareBlocks = newSpareBlocks;
+    spareCapacity = capacity;
+}
+
+/**************************************************************************************************
+ * @brief Fills the spare block cache with the blocks held for outstanding reservations.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::reserveSpareBlocks() {
+    size_t reserved = reservedFront + reservedBack;
+    if (reserved > spareCapacity) {
+        resizeSpareCache(reserved);
+    }
+    while (spareCount < reserved) {
+        spareBlocks[spareCount++] = newBlock();
+    }
+}
+
+/**************************************************************************************************
+ * @brief Ensures the map has at least a given number of free slots before the front block.
+ * 
+ * @param blocks The number of free slots required.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::reserveMapFront(size_t blocks) {
+    if (frontIndex < blocks) {
+        growMap(blocks, true);
+    }
+}
+
+/**************************************************************************************************
+ * @brief Ensures the map has at least a given number of free slots after the back block.
+ * 
+ * @param blocks The number of free slots required.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::reserveMapBack(size_t blocks) {
+    if (mapSize - 1 - backIndex < blocks) {
+        growMap(blocks, false);
+    }
+}
+
+/**************************************************************************************************
+ * @brief Makes room in the map for more blocks at one end.
+ * 
+ * The blocks in use, plus the slots reserved at each end and the requested slots, form the
+ * required span. If that span fits in less than half of the current map, the blocks are
+ * recentered in place and no memory is allocated. Otherwise the map grows to at least twice
+ * its size. In both cases the spare slots are split unevenly: the end under pressure gets
+ * three quarters and the other end one quarter. This way a queue that pushes at the back
+ * and pops at the front keeps reusing the same map instead of doubling it forever. The
+ * front and back indices are rebased to the new positions.
+ * 
+ * @param blocks  The number of free slots needed at the growing end.
+ * @param atFront true to make room before the front block, false for after the back block.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats>
+void Deque<T, BLOCK_SIZE, Allocator, Stats>::growMap(size_t blocks, bool atFront) {
+    statsPolicy.on_grow_begin();
+    size_t used = backIndex - frontIndex + 1;
+    size_t needFront = atFront ? std::max(blocks, reservedFront) : reservedFront;
+    size_t needBack = atFront ? reservedBack : std::max(blocks, reservedBack);
+    size_t required = used + needFront + needBack;
+
+    size_t newMapSize = mapSize;
+    T** newMap = map;
+    if (2 * required >= mapSize) {
+        newMapSize = std::max(2 * mapSize, 2 * required);
+        newMap = allocateMap(newMapSize);
+        for (size_t i = 0; i < newMapSize; ++i) {
+            newMap[i] = nullptr;
+        }
+    }
+
+    size_t extra = newMapSize - required;
+    size_t newFrontIndex = needFront + (atFront ? extra - extra / 4 : extra / 4);
+
+    bool reallocated = (newMap != map);
+    if (!reallocated) {
+        if (newFrontIndex < frontIndex) {
+            std::copy(map + frontIndex, map + backIndex + 1, map + newFrontIndex);
+        } else {
+            std::copy_backward(map + frontIndex, map + backIndex + 1, map + newFrontIndex + used);
+        }
+        for (size_t i = frontIndex; i <= backIndex; ++i) {
+            if (i < newFrontIndex || i >= newFrontIndex + used) {
+                map[i] = nullptr;
+            }
+        }
+    } else {
+        std::copy(map + frontIndex, map + backIndex + 1, newMap + newFrontIndex);
+        deallocateMap(map, mapSize);
+        map = newMap;
+        mapSize = newMapSize;
+    }
+
+    frontIndex = newFrontIndex;
+    backIndex = newFrontIndex + used - 1;
+    statsPolicy.on_grow_end(reallocated, used * sizeof(T*));
 }
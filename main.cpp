@@ -63,6 +63,20 @@ int main() {
     std::cout << "Iterator after += 2: " << *it3 << std::endl;
     it3 -= 1;
     std::cout << "Iterator after -= 1: " << *it3 << std::endl;
+
+    // Test front, back and pop operations
+    std::cout << "Front: " << dq.front() << ", back: " << dq.back() << std::endl;
+    dq.pop_front();
+    dq.pop_back();
+    std::cout << "After pop_front and pop_back: ";
+    for (auto it = dq.begin(); it != dq.end(); ++it) {
+        std::cout << *it << " ";
+    }
+    std::cout << std::endl;
+
+    // Test clear
+    dq.clear();
+    std::cout << "Deque size after clear: " << dq.size() << std::endl;
     
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,73 @@
+#ifndef MAPPED_DEQUE_H
+#define MAPPED_DEQUE_H
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "dequeHeader.hpp"
+
+/**************************************************************************************************
+ * @brief Read-only view of a Deque snapshot mapped into memory.
+ * 
+ * Maps a file written by Deque::save() with mmap() and serves element access and iteration
+ * straight from the mapping, so opening a snapshot costs the same no matter how large it is.
+ * Pages are read in by the kernel on first access. The blocks of a snapshot are stored back
+ * to back, so the elements form one contiguous array and the iterators are plain pointers.
+ * 
+ * The snapshot must have been written by a Deque with the same element size, alignment and
+ * BLOCK_SIZE; otherwise the constructor throws a std::runtime_error.
+ * 
+ * @tparam T          Element type; must be trivially copyable.
+ * @tparam BLOCK_SIZE Number of elements per block of the Deque that wrote the snapshot.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE = DequeBlockSize<T>::value>
+class MappedDeque {
+    static_assert(std::is_trivially_copyable_v<T>, "MappedDeque requires a trivially copyable T.");
+
+private:
+    void* mapping;
+    size_t mappingBytes;
+    const T* elements;
+    size_t count;
+    size_t frontOffset;
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = const T&;
+    using const_reference = const T&;
+    using iterator = const T*;
+    using const_iterator = const T*;
+
+    explicit MappedDeque(const std::filesystem::path&);
+    MappedDeque(const MappedDeque&) = delete;
+    MappedDeque& operator=(const MappedDeque&) = delete;
+    MappedDeque(MappedDeque&&) noexcept;
+    MappedDeque& operator=(MappedDeque&&) noexcept;
+    ~MappedDeque();
+
+    bool empty() const;
+    size_t size() const;
+    const T& operator[](size_t) const;
+    const T& at(size_t) const;
+    const T& front() const;
+    const T& back() const;
+    const T* begin() const;
+    const T* end() const;
+    const T* cbegin() const;
+    const T* cend() const;
+    template <typename F>
+    void for_each_segment(F&&) const;
+
+private:
+    void unmap();
+};
+
+#include "mappedDequeImplementation.tpp"
+
+#endif
@@ -0,0 +1,230 @@
+#include "mappedDequeHeader.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**************************************************************************************************
+ * @brief Maps a snapshot file and checks its header.
+ * 
+ * The file is mapped read-only and privately; the descriptor is closed again right away.
+ * Throws a std::runtime_error if the file cannot be opened or mapped, or if its header does
+ * not match T and BLOCK_SIZE.
+ * 
+ * @param path The snapshot file written by Deque::save().
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+MappedDeque<T, BLOCK_SIZE>::MappedDeque(const std::filesystem::path& path)
+    : mapping(nullptr), mappingBytes(0), elements(nullptr), count(0), frontOffset(0) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open snapshot file.\n");
+    }
+    struct stat status;
+    if (::fstat(fd, &status) != 0 || static_cast<size_t>(status.st_size) < sizeof(DequeSnapshotHeader)) {
+        ::close(fd);
+        throw std::runtime_error("Snapshot is corrupt or truncated.\n");
+    }
+
+    mappingBytes = static_cast<size_t>(status.st_size);
+    mapping = ::mmap(nullptr, mappingBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        mapping = nullptr;
+        throw std::runtime_error("Cannot map snapshot file.\n");
+    }
+
+    const DequeSnapshotHeader* header = static_cast<const DequeSnapshotHeader*>(mapping);
+    try {
+        header->validate<T, BLOCK_SIZE>(mappingBytes);
+    } catch (...) {
+        unmap();
+        throw;
+    }
+    elements = reinterpret_cast<const T*>(static_cast<const char*>(mapping) + header->headerBytes) + header->frontOffset;
+    count = header->size;
+    frontOffset = header->frontOffset;
+}
+
+/**************************************************************************************************
+ * @brief Move constructor. Takes over the mapping; the source is left empty.
+ * 
+ * @param other The view to move from.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+MappedDeque<T, BLOCK_SIZE>::MappedDeque(MappedDeque&& other) noexcept
+    : mapping(std::exchange(other.mapping, nullptr)), mappingBytes(std::exchange(other.mappingBytes, 0)),
+      elements(std::exchange(other.elements, nullptr)), count(std::exchange(other.count, 0)),
+      frontOffset(std::exchange(other.frontOffset, 0)) {}
+
+/**************************************************************************************************
+ * @brief Move assignment operator. Unmaps the current snapshot and takes over the other one.
+ * 
+ * @param other The view to move from.
+ * @return Reference to this view.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+MappedDeque<T, BLOCK_SIZE>& MappedDeque<T, BLOCK_SIZE>::operator=(MappedDeque&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        mapping = std::exchange(other.mapping, nullptr);
+        mappingBytes = std::exchange(other.mappingBytes, 0);
+        elements = std::exchange(other.elements, nullptr);
+        count = std::exchange(other.count, 0);
+        frontOffset = std::exchange(other.frontOffset, 0);
+    }
+    return *this;
+}
+
+/**************************************************************************************************
+ * @brief Destructor. Unmaps the snapshot.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+MappedDeque<T, BLOCK_SIZE>::~MappedDeque() {
+    unmap();
+}
+
+/**************************************************************************************************
+ * @brief Checks if the snapshot holds no elements.
+ * 
+ * @return true if there are no elements; otherwise, false.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+bool MappedDeque<T, BLOCK_SIZE>::empty() const {
+    return count == 0;
+}
+
+/**************************************************************************************************
+ * @brief Returns the number of elements in the snapshot.
+ * 
+ * @return The number of elements.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+size_t MappedDeque<T, BLOCK_SIZE>::size() const {
+    return count;
+}
+
+/**************************************************************************************************
+ * @brief Access operator.
+ * 
+ * @param index The position of the element.
+ * @return Reference to the element in the mapping.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+const T& MappedDeque<T, BLOCK_SIZE>::operator[](size_t index) const {
+    return elements[index];
+}
+
+/**************************************************************************************************
+ * @brief Accesses an element with bounds checking.
+ * 
+ * Throws a std::runtime_error if the index is out of bounds.
+ * 
+ * @param index The position of the element.
+ * @return Reference to the element in the mapping.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+const T& MappedDeque<T, BLOCK_SIZE>::at(size_t index) const {
+    if (index >= count) {
+        throw std::runtime_error("Invalid index.\n");
+    }
+    return elements[index];
+}
+
+/**************************************************************************************************
+ * @brief Returns the first element.
+ * 
+ * @return Reference to the first element.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+const T& MappedDeque<T, BLOCK_SIZE>::front() const {
+    if (empty()) {
+        throw std::runtime_error("Deque is empty.\n");
+    }
+    return elements[0];
+}
+
+/**************************************************************************************************
+ * @brief Returns the last element.
+ * 
+ * @return Reference to the last element.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+const T& MappedDeque<T, BLOCK_SIZE>::back() const {
+    if (empty()) {
+        throw std::runtime_error("Deque is empty.\n");
+    }
+    return elements[count - 1];
+}
+
+/**************************************************************************************************
+ * @brief Returns an iterator to the first element.
+ * 
+ * @return Pointer to the first element in the mapping.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+const T* MappedDeque<T, BLOCK_SIZE>::begin() const {
+    return elements;
+}
+
+/**************************************************************************************************
+ * @brief Returns an iterator one past the last element.
+ * 
+ * @return Pointer one past the last element in the mapping.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+const T* MappedDeque<T, BLOCK_SIZE>::end() const {
+    return elements + count;
+}
+
+/**************************************************************************************************
+ * @brief Returns a constant iterator to the first element.
+ * 
+ * @return Pointer to the first element in the mapping.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+const T* MappedDeque<T, BLOCK_SIZE>::cbegin() const {
+    return begin();
+}
+
+/**************************************************************************************************
+ * @brief Returns a constant iterator one past the last element.
+ * 
+ * @return Pointer one past the last element in the mapping.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+const T* MappedDeque<T, BLOCK_SIZE>::cend() const {
+    return end();
+}
+
+/**************************************************************************************************
+ * @brief Calls a function once per block of the saved deque.
+ * 
+ * Matches Deque::for_each_segment(), so code written against segments works on both.
+ * 
+ * @param f Function invoked with a std::span<const T> for every non-empty block.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+template <typename F>
+void MappedDeque<T, BLOCK_SIZE>::for_each_segment(F&& f) const {
+    size_t done = 0;
+    size_t room = BLOCK_SIZE - frontOffset;
+    while (done < count) {
+        size_t chunk = room < count - done ? room : count - done;
+        f(std::span<const T>(elements + done, chunk));
+        done += chunk;
+        room = BLOCK_SIZE;
+    }
+}
+
+/**************************************************************************************************
+ * @brief Releases the mapping, if any.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+void MappedDeque<T, BLOCK_SIZE>::unmap() {
+    if (mapping != nullptr) {
+        ::munmap(mapping, mappingBytes);
+        mapping = nullptr;
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef PARALLEL_DEQUE_H
+#define PARALLEL_DEQUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "dequeHeader.hpp"
+
+/**************************************************************************************************
+ * @brief Fixed-size pool of std::thread workers for the parallel Deque algorithms.
+ * 
+ * run() hands out task indices to the workers and the calling thread, which also runs tasks,
+ * and returns once every task has finished. If a task throws, the remaining tasks still run
+ * and the first exception is rethrown from run(). Calls to run() from different threads are
+ * serialized; a task must not call run() on the same pool.
+ **************************************************************************************************/
+class DequeThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::mutex runMutex;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    const std::function<void(size_t)>* job;
+    size_t jobTasks;
+    std::atomic<size_t> nextTask;
+    size_t pending;
+    size_t active;
+    size_t generation;
+    bool stopping;
+    std::exception_ptr error;
+
+public:
+    explicit DequeThreadPool(size_t threads = std::thread::hardware_concurrency());
+    DequeThreadPool(const DequeThreadPool&) = delete;
+    DequeThreadPool& operator=(const DequeThreadPool&) = delete;
+    ~DequeThreadPool();
+
+    size_t concurrency() const;
+    void run(size_t, const std::function<void(size_t)>&);
+    static DequeThreadPool& shared();
+
+private:
+    void workerLoop();
+    void drain(const std::function<void(size_t)>*, size_t);
+};
+
+/**************************************************************************************************
+ * Parallel algorithms over Deque.
+ * 
+ * The deque is cut into chunks of whole blocks, one task per chunk, so workers never write to
+ * the same block and each task runs over contiguous spans. Every algorithm takes the pool to
+ * run on as its last argument and uses DequeThreadPool::shared() by default.
+ **************************************************************************************************/
+
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats, typename F>
+void parallel_for_each(Deque<T, BLOCK_SIZE, Allocator, Stats>&, F, DequeThreadPool& = DequeThreadPool::shared());
+
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats, std::random_access_iterator Out, typename F>
+Out parallel_transform(const Deque<T, BLOCK_SIZE, Allocator, Stats>&, Out, F, DequeThreadPool& = DequeThreadPool::shared());
+
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats, typename U, typename BinaryOp = std::plus<>>
+U parallel_reduce(const Deque<T, BLOCK_SIZE, Allocator, Stats>&, U, BinaryOp = BinaryOp(),
+                  DequeThreadPool& = DequeThreadPool::shared());
+
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats, typename Predicate>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator
+parallel_find_if(Deque<T, BLOCK_SIZE, Allocator, Stats>&, Predicate, DequeThreadPool& = DequeThreadPool::shared());
+
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats, typename Compare = std::less<>>
+void parallel_sort(Deque<T, BLOCK_SIZE, Allocator, Stats>&, Compare = Compare(),
+                   DequeThreadPool& = DequeThreadPool::shared());
+
+#include "parallelDequeImplementation.tpp"
+
+#endif
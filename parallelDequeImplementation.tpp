@@ -0,0 +1,347 @@
+#include "parallelDequeHeader.hpp"
+
+/**************************************************************************************************
+ * @brief Starts the worker threads.
+ * 
+ * The calling thread of run() always takes part, so threads - 1 workers are started.
+ * 
+ * @param threads The total number of threads that run tasks, including the caller.
+ **************************************************************************************************/
+inline DequeThreadPool::DequeThreadPool(size_t threads)
+    : job(nullptr), jobTasks(0), nextTask(0), pending(0), active(0), generation(0), stopping(false) {
+    for (size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(&DequeThreadPool::workerLoop, this);
+    }
+}
+
+/**************************************************************************************************
+ * @brief Stops and joins the worker threads.
+ **************************************************************************************************/
+inline DequeThreadPool::~DequeThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/**************************************************************************************************
+ * @brief Returns the number of threads that run tasks, including the caller of run().
+ * 
+ * @return The number of worker threads plus one.
+ **************************************************************************************************/
+inline size_t DequeThreadPool::concurrency() const {
+    return workers.size() + 1;
+}
+
+/**************************************************************************************************
+ * @brief Runs task(0) ... task(tasks - 1) on the pool and waits for all of them.
+ * 
+ * Tasks are claimed in increasing index order with one atomic increment each. The caller
+ * claims tasks too, so a pool without workers runs everything inline.
+ * 
+ * @param tasks The number of tasks.
+ * @param task  Function invoked with each task index.
+ **************************************************************************************************/
+inline void DequeThreadPool::run(size_t tasks, const std::function<void(size_t)>& task) {
+    if (!tasks) {
+        return;
+    }
+    std::lock_guard<std::mutex> serial(runMutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &task;
+        jobTasks = tasks;
+        nextTask.store(0, std::memory_order_relaxed);
+        pending = tasks;
+        ++generation;
+    }
+    wake.notify_all();
+    drain(&task, tasks);
+
+    std::exception_ptr failure;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this] { return pending == 0 && active == 0; });
+        job = nullptr;
+        jobTasks = 0;
+        failure = std::exchange(error, nullptr);
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+/**************************************************************************************************
+ * @brief Returns the process-wide pool used by default, sized to the hardware concurrency.
+ * 
+ * @return Reference to the shared pool.
+ **************************************************************************************************/
+inline DequeThreadPool& DequeThreadPool::shared() {
+    static DequeThreadPool pool;
+    return pool;
+}
+
+/**************************************************************************************************
+ * @brief Body of each worker thread.
+ * 
+ * Sleeps until a new job is published, registers as active while it claims tasks and sleeps
+ * again. run() waits for active workers as well as pending tasks, so a late worker can never
+ * claim an index of the next job with the previous job's function.
+ **************************************************************************************************/
+inline void DequeThreadPool::workerLoop() {
+    size_t seen = 0;
+    while (true) {
+        const std::function<void(size_t)>* current;
+        size_t tasks;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            if (job == nullptr) {
+                continue;
+            }
+            current = job;
+            tasks = jobTasks;
+            ++active;
+        }
+        drain(current, tasks);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --active;
+        }
+        finished.notify_all();
+    }
+}
+
+/**************************************************************************************************
+ * @brief Claims and runs tasks of the current job until none are left.
+ * 
+ * @param task  The job's task function.
+ * @param tasks The job's number of tasks.
+ **************************************************************************************************/
+inline void DequeThreadPool::drain(const std::function<void(size_t)>* task, size_t tasks) {
+    for (size_t i = nextTask.fetch_add(1, std::memory_order_relaxed); i < tasks;
+         i = nextTask.fetch_add(1, std::memory_order_relaxed)) {
+        std::exception_ptr failure;
+        try {
+            (*task)(i);
+        } catch (...) {
+            failure = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (failure && !error) {
+            error = failure;
+        }
+        if (--pending == 0) {
+            finished.notify_all();
+        }
+    }
+}
+
+/**************************************************************************************************
+ * @brief Lists the contiguous segments of a deque with the index of their first element.
+ * 
+ * @param d The deque (const or not).
+ * @return One (span, start index) pair per non-empty block, from front to back.
+ **************************************************************************************************/
+template <typename D>
+auto collectSegments(D& d) {
+    using Element = std::conditional_t<std::is_const_v<D>, const typename D::value_type, typename D::value_type>;
+    std::vector<std::pair<std::span<Element>, size_t>> segments;
+    size_t start = 0;
+    d.for_each_segment([&](std::span<Element> segment) {
+        segments.emplace_back(segment, start);
+        start += segment.size();
+    });
+    return segments;
+}
+
+/**************************************************************************************************
+ * @brief Splits a list of segments into at most parts chunks of about equal length.
+ * 
+ * Every segment but the first and last is a full block, so equal segment counts mean equal
+ * element counts.
+ * 
+ * @param segments The number of segments.
+ * @param parts    The desired number of chunks.
+ * @return Chunk boundaries as segment indices: chunk i covers [result[i], result[i + 1]).
+ **************************************************************************************************/
+inline std::vector<size_t> partitionSegments(size_t segments, size_t parts) {
+    parts = std::clamp<size_t>(parts, 1, std::max<size_t>(segments, 1));
+    std::vector<size_t> bounds(parts + 1);
+    for (size_t i = 0; i <= parts; ++i) {
+        bounds[i] = segments * i / parts;
+    }
+    return bounds;
+}
+
+/**************************************************************************************************
+ * @brief Calls a function on every element, in parallel.
+ * 
+ * Each task walks the spans of its chunk, so the function is never called on two elements of
+ * the same block from different threads.
+ * 
+ * @param d    The deque.
+ * @param f    Function invoked with a T& for every element.
+ * @param pool The pool to run on.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats, typename F>
+void parallel_for_each(Deque<T, BLOCK_SIZE, Allocator, Stats>& d, F f, DequeThreadPool& pool) {
+    auto segments = collectSegments(d);
+    std::vector<size_t> bounds = partitionSegments(segments.size(), 4 * pool.concurrency());
+    pool.run(bounds.size() - 1, [&](size_t chunk) {
+        for (size_t i = bounds[chunk]; i < bounds[chunk + 1]; ++i) {
+            for (T& value : segments[i].first) {
+                f(value);
+            }
+        }
+    });
+}
+
+/**************************************************************************************************
+ * @brief Writes f(element) for every element to an output range, in parallel.
+ * 
+ * The output is indexed like the deque, so passing d.begin() transforms the deque in place.
+ * 
+ * @param d    The deque to read.
+ * @param out  Start of an output range with room for d.size() values.
+ * @param f    Function applied to every element.
+ * @param pool The pool to run on.
+ * @return Iterator one past the last value written.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats, std::random_access_iterator Out, typename F>
+Out parallel_transform(const Deque<T, BLOCK_SIZE, Allocator, Stats>& d, Out out, F f, DequeThreadPool& pool) {
+    auto segments = collectSegments(d);
+    std::vector<size_t> bounds = partitionSegments(segments.size(), 4 * pool.concurrency());
+    pool.run(bounds.size() - 1, [&](size_t chunk) {
+        for (size_t i = bounds[chunk]; i < bounds[chunk + 1]; ++i) {
+            Out dest = out + static_cast<std::iter_difference_t<Out>>(segments[i].second);
+            for (const T& value : segments[i].first) {
+                *dest = f(value);
+                ++dest;
+            }
+        }
+    });
+    return out + static_cast<std::iter_difference_t<Out>>(d.size());
+}
+
+/**************************************************************************************************
+ * @brief Combines every element with a binary operation, in parallel.
+ * 
+ * Each chunk is folded from its first element on, and the partial results are folded into
+ * init in front-to-back order, so op must be associative but need not be commutative.
+ * 
+ * @param d    The deque to read.
+ * @param init The initial value.
+ * @param op   The binary operation.
+ * @param pool The pool to run on.
+ * @return init combined with every element.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats, typename U, typename BinaryOp>
+U parallel_reduce(const Deque<T, BLOCK_SIZE, Allocator, Stats>& d, U init, BinaryOp op, DequeThreadPool& pool) {
+    auto segments = collectSegments(d);
+    std::vector<size_t> bounds = partitionSegments(segments.size(), 4 * pool.concurrency());
+    std::vector<std::optional<U>> partials(bounds.size() - 1);
+    pool.run(bounds.size() - 1, [&](size_t chunk) {
+        std::optional<U> partial;
+        for (size_t i = bounds[chunk]; i < bounds[chunk + 1]; ++i) {
+            for (const T& value : segments[i].first) {
+                if (partial) {
+                    partial = op(std::move(*partial), value);
+                } else {
+                    partial.emplace(value);
+                }
+            }
+        }
+        partials[chunk] = std::move(partial);
+    });
+
+    for (std::optional<U>& partial : partials) {
+        if (partial) {
+            init = op(std::move(init), std::move(*partial));
+        }
+    }
+    return init;
+}
+
+/**************************************************************************************************
+ * @brief Finds the first element that satisfies a predicate, in parallel.
+ * 
+ * Chunks are searched concurrently. The lowest matching index found so far is shared, and a
+ * task stops as soon as the rest of its chunk lies past it.
+ * 
+ * @param d    The deque to search.
+ * @param pred The predicate.
+ * @param pool The pool to run on.
+ * @return Iterator to the first matching element, or end() if there is none.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats, typename Predicate>
+typename Deque<T, BLOCK_SIZE, Allocator, Stats>::iterator
+parallel_find_if(Deque<T, BLOCK_SIZE, Allocator, Stats>& d, Predicate pred, DequeThreadPool& pool) {
+    auto segments = collectSegments(d);
+    std::vector<size_t> bounds = partitionSegments(segments.size(), 4 * pool.concurrency());
+    std::atomic<size_t> found(d.size());
+    pool.run(bounds.size() - 1, [&](size_t chunk) {
+        for (size_t i = bounds[chunk]; i < bounds[chunk + 1]; ++i) {
+            size_t index = segments[i].second;
+            if (index >= found.load(std::memory_order_relaxed)) {
+                return;
+            }
+            for (T& value : segments[i].first) {
+                if (pred(value)) {
+                    size_t best = found.load(std::memory_order_relaxed);
+                    while (index < best && !found.compare_exchange_weak(best, index, std::memory_order_relaxed)) {
+                    }
+                    return;
+                }
+                ++index;
+            }
+        }
+    });
+    return d.begin() + static_cast<std::ptrdiff_t>(found.load());
+}
+
+/**************************************************************************************************
+ * @brief Sorts the deque, in parallel.
+ * 
+ * Cuts the deque into one block-aligned chunk per thread and sorts the chunks concurrently.
+ * The sorted runs are then merged pairwise with std::inplace_merge, with the merges of each
+ * round running concurrently, until a single run is left. Not stable.
+ * 
+ * @param d    The deque to sort.
+ * @param comp The comparison.
+ * @param pool The pool to run on.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE, typename Allocator, typename Stats, typename Compare>
+void parallel_sort(Deque<T, BLOCK_SIZE, Allocator, Stats>& d, Compare comp, DequeThreadPool& pool) {
+    auto segments = collectSegments(d);
+    std::vector<size_t> bounds = partitionSegments(segments.size(), pool.concurrency());
+    size_t runs = bounds.size() - 1;
+    std::vector<std::ptrdiff_t> starts(runs + 1);
+    for (size_t i = 0; i < runs; ++i) {
+        starts[i] = static_cast<std::ptrdiff_t>(bounds[i] < segments.size() ? segments[bounds[i]].second : d.size());
+    }
+    starts[runs] = static_cast<std::ptrdiff_t>(d.size());
+
+    auto first = d.begin();
+    pool.run(runs, [&](size_t run) {
+        std::sort(first + starts[run], first + starts[run + 1], comp);
+    });
+    for (size_t width = 1; width < runs; width *= 2) {
+        pool.run((runs + 2 * width - 1) / (2 * width), [&](size_t pair) {
+            size_t left = 2 * width * pair;
+            size_t middle = left + width;
+            if (middle < runs) {
+                size_t right = std::min(middle + width, runs);
+                std::inplace_merge(first + starts[left], first + starts[middle], first + starts[right], comp);
+            }
+        });
+    }
+}
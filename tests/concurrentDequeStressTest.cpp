@@ -0,0 +1,347 @@
+#include "concurrentDequeHeader.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**************************************************************************************************
+ * Multi-threaded stress test for ConcurrentDeque and BoundedMPMCQueue.
+ *
+ * Every element pushed carries a unique id. Each id that is popped, stolen or dequeued is
+ * recorded, and after all threads have joined every id must have been claimed exactly once.
+ * Meant to be run under ThreadSanitizer and AddressSanitizer as well as in the normal build.
+ *
+ * Usage: concurrentDequeStressTest [rounds] [elements]
+ **************************************************************************************************/
+
+#define CHECK(condition)                                                                           \
+    do {                                                                                           \
+        if (!(condition)) {                                                                        \
+            std::cerr << "CHECK failed: " #condition " (" << __FILE__ << ":" << __LINE__ << ")"  \
+                      << " round " << round << std::endl;                                          \
+            std::exit(1);                                                                          \
+        }                                                                                          \
+    } while (0)
+
+/**************************************************************************************************
+ * @brief One owner pushes and pops while several thieves steal from the front.
+ *
+ * The deque starts with a tiny capacity and small blocks, so it grows many times while
+ * thieves are reading it.
+ **************************************************************************************************/
+template <size_t BLOCK_SIZE>
+void stressWorkStealing(unsigned round, size_t elements, size_t thieves) {
+    ConcurrentDeque<std::uint64_t, BLOCK_SIZE> deque(1);
+    std::unique_ptr<std::atomic<std::uint32_t>[]> claimed(new std::atomic<std::uint32_t>[elements]);
+    for (size_t i = 0; i < elements; ++i) {
+        claimed[i].store(0, std::memory_order_relaxed);
+    }
+    std::atomic<bool> done(false);
+    std::atomic<size_t> stolen(0);
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < thieves; ++i) {
+        workers.emplace_back([&] {
+            while (!done.load(std::memory_order_acquire)) {
+                if (auto value = deque.steal()) {
+                    claimed[*value].fetch_add(1, std::memory_order_relaxed);
+                    stolen.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    std::mt19937 rng(round);
+    size_t popped = 0;
+    size_t next = 0;
+    while (next < elements) {
+        for (size_t burst = rng() % 64; burst > 0 && next < elements; --burst) {
+            deque.push(next++);
+        }
+        for (size_t burst = rng() % 48; burst > 0; --burst) {
+            if (auto value = deque.pop()) {
+                claimed[*value].fetch_add(1, std::memory_order_relaxed);
+                ++popped;
+            }
+        }
+    }
+    while (!deque.empty()) {
+        if (auto value = deque.pop()) {
+            claimed[*value].fetch_add(1, std::memory_order_relaxed);
+            ++popped;
+        }
+    }
+    done.store(true, std::memory_order_release);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    CHECK(deque.empty());
+    CHECK(deque.capacity() >= 1);
+    CHECK(popped + stolen.load() == elements);
+    for (size_t i = 0; i < elements; ++i) {
+        CHECK(claimed[i].load(std::memory_order_relaxed) == 1);
+    }
+}
+
+/**************************************************************************************************
+ * @brief Several producers and consumers share a small BoundedMPMCQueue.
+ *
+ * Besides exactly-once delivery, each consumer must see the values of any one producer in
+ * the order they were pushed.
+ **************************************************************************************************/
+void stressBoundedQueue(unsigned round, size_t elements, size_t producers, size_t consumers) {
+    BoundedMPMCQueue<std::uint64_t> queue(16);
+    size_t perProducer = elements / producers;
+    size_t total = perProducer * producers;
+    std::unique_ptr<std::atomic<std::uint32_t>[]> claimed(new std::atomic<std::uint32_t>[total]);
+    for (size_t i = 0; i < total; ++i) {
+        claimed[i].store(0, std::memory_order_relaxed);
+    }
+    std::atomic<size_t> consumed(0);
+    std::atomic<bool> ordered(true);
+
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (size_t i = 0; i < perProducer; ++i) {
+                while (!queue.try_push(p * perProducer + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (size_t c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            std::vector<std::int64_t> last(producers, -1);
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                if (auto value = queue.try_pop()) {
+                    size_t producer = *value / perProducer;
+                    std::int64_t index = static_cast<std::int64_t>(*value % perProducer);
+                    if (index <= last[producer]) {
+                        ordered.store(false, std::memory_order_relaxed);
+                    }
+                    last[producer] = index;
+                    claimed[*value].fetch_add(1, std::memory_order_relaxed);
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    CHECK(ordered.load());
+    CHECK(!queue.try_pop());
+    for (size_t i = 0; i < total; ++i) {
+        CHECK(claimed[i].load(std::memory_order_relaxed) == 1);
+    }
+}
+
+/**************************************************************************************************
+ * @brief Producers and consumers exchange heap-owning strings, leaving some queued at the end.
+ *
+ * Checks that elements are moved out intact and that the destructor releases the ones left.
+ **************************************************************************************************/
+void stressBoundedQueueStrings(unsigned round, size_t elements) {
+    BoundedMPMCQueue<std::string> queue(64);
+    std::atomic<size_t> pushed(0);
+    std::atomic<size_t> popped(0);
+    std::atomic<bool> intact(true);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 2; ++t) {
+        threads.emplace_back([&] {
+            for (size_t i = 0; i < elements; ++i) {
+                if (queue.try_emplace(std::string(40, 'x'))) {
+                    pushed.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+        threads.emplace_back([&] {
+            for (size_t i = 0; i < elements / 2; ++i) {
+                if (auto value = queue.try_pop()) {
+                    intact.store(intact.load() && *value == std::string(40, 'x'), std::memory_order_relaxed);
+                    popped.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    CHECK(intact.load());
+    CHECK(pushed.load() >= popped.load());
+    CHECK(pushed.load() - popped.load() <= queue.capacity());
+}
+
+/**************************************************************************************************
+ * @brief Producers retry moving unique_ptrs into a small queue that is mostly full.
+ *
+ * A push that fails must leave its argument intact, so every retry loop eventually delivers
+ * the original pointer and no consumer ever receives an empty one.
+ **************************************************************************************************/
+void stressBoundedQueueMoveOnly(unsigned round, size_t elements, size_t producers, size_t consumers) {
+    BoundedMPMCQueue<std::unique_ptr<std::uint64_t>> queue(4);
+    size_t perProducer = elements / producers;
+    size_t total = perProducer * producers;
+    std::unique_ptr<std::atomic<std::uint32_t>[]> claimed(new std::atomic<std::uint32_t>[total]);
+    for (size_t i = 0; i < total; ++i) {
+        claimed[i].store(0, std::memory_order_relaxed);
+    }
+    std::atomic<size_t> consumed(0);
+    std::atomic<bool> intact(true);
+
+    while (queue.try_emplace(std::make_unique<std::uint64_t>(0))) {
+    }
+    auto rejected = std::make_unique<std::uint64_t>(0);
+    CHECK(!queue.try_push(std::move(rejected)));
+    CHECK(rejected != nullptr);
+    CHECK(!queue.try_emplace(std::move(rejected)));
+    CHECK(rejected != nullptr);
+    while (queue.try_pop()) {
+    }
+
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (size_t i = 0; i < perProducer; ++i) {
+                auto element = std::make_unique<std::uint64_t>(p * perProducer + i);
+                while (!queue.try_push(std::move(element))) {
+                    if (element == nullptr) {
+                        intact.store(false, std::memory_order_relaxed);
+                        break;
+                    }
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (size_t c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            while (consumed.load(std::memory_order_relaxed) < total && intact.load(std::memory_order_relaxed)) {
+                if (auto value = queue.try_pop()) {
+                    if (*value == nullptr) {
+                        intact.store(false, std::memory_order_relaxed);
+                    } else {
+                        claimed[**value].fetch_add(1, std::memory_order_relaxed);
+                    }
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    CHECK(intact.load());
+    CHECK(!queue.try_pop());
+    for (size_t i = 0; i < total; ++i) {
+        CHECK(claimed[i].load(std::memory_order_relaxed) == 1);
+    }
+}
+
+/**************************************************************************************************
+ * @brief Element whose constructor throws on request, to check that a failed try_emplace()
+ *        leaves no claimed but unpublished cell behind.
+ **************************************************************************************************/
+struct ThrowingElement {
+    std::uint64_t id;
+
+    ThrowingElement(std::uint64_t value, bool fail) : id(value) {
+        if (fail) {
+            throw std::runtime_error("ThrowingElement construction failed.\n");
+        }
+    }
+    ThrowingElement(ThrowingElement&&) noexcept = default;
+};
+
+/**************************************************************************************************
+ * @brief Producers whose constructors throw now and then, racing consumers.
+ *
+ * Every element that was constructed must still reach a consumer exactly once.
+ **************************************************************************************************/
+void stressBoundedQueueThrowing(unsigned round, size_t elements, size_t producers, size_t consumers) {
+    BoundedMPMCQueue<ThrowingElement> queue(8);
+    size_t perProducer = elements / producers;
+    size_t total = perProducer * producers;
+    std::unique_ptr<std::atomic<std::uint32_t>[]> claimed(new std::atomic<std::uint32_t>[total]);
+    for (size_t i = 0; i < total; ++i) {
+        claimed[i].store(0, std::memory_order_relaxed);
+    }
+    std::atomic<size_t> expected(0);
+    std::atomic<size_t> consumed(0);
+    std::atomic<size_t> producing(producers);
+
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (size_t i = 0; i < perProducer; ++i) {
+                size_t id = p * perProducer + i;
+                try {
+                    while (!queue.try_emplace(id, id % 7 == 3)) {
+                        std::this_thread::yield();
+                    }
+                    expected.fetch_add(1, std::memory_order_relaxed);
+                } catch (const std::runtime_error&) {
+                }
+            }
+            producing.fetch_sub(1, std::memory_order_release);
+        });
+    }
+    for (size_t c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            for (;;) {
+                bool finished = producing.load(std::memory_order_acquire) == 0;
+                if (auto value = queue.try_pop()) {
+                    claimed[value->id].fetch_add(1, std::memory_order_relaxed);
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                } else if (finished) {
+                    break;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    CHECK(consumed.load() == expected.load());
+    for (size_t i = 0; i < total; ++i) {
+        CHECK(claimed[i].load(std::memory_order_relaxed) == (i % 7 == 3 ? 0u : 1u));
+    }
+}
+
+int main(int argc, char** argv) {
+    unsigned rounds = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : 10;
+    size_t elements = argc > 2 ? static_cast<size_t>(std::atoll(argv[2])) : 100000;
+
+    for (unsigned round = 1; round <= rounds; ++round) {
+        stressWorkStealing<4>(round, elements, 3);
+        stressWorkStealing<64>(round, elements, 1);
+        stressBoundedQueue(round, elements, 3, 3);
+        stressBoundedQueue(round, elements, 1, 4);
+        stressBoundedQueueStrings(round, elements / 10);
+        stressBoundedQueueMoveOnly(round, elements / 10, 3, 1);
+        stressBoundedQueueThrowing(round, elements / 10, 2, 2);
+    }
+
+    std::cout << "concurrentDequeStressTest: every element claimed exactly once" << std::endl;
+    return 0;
+}
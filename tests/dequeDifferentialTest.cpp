@@ -0,0 +1,918 @@
+#include "dequeHeader.hpp"
+#include "mappedDequeHeader.hpp"
+#include "parallelDequeHeader.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <list>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+/**************************************************************************************************
+ * Randomized differential test: replays the same operation stream on Deque and std::deque and
+ * compares the full contents after every step. A failure reports the seed and step so the
+ * stream can be replayed.
+ * 
+ * Usage: dequeDifferentialTest [seeds] [steps]
+ **************************************************************************************************/
+
+#define CHECK(condition)                                                                           \
+    do {                                                                                           \
+        if (!(condition)) {                                                                        \
+            std::cerr << "CHECK failed: " #condition " (" << __FILE__ << ":" << __LINE__ << ")"  \
+                      << " seed " << seed << " step " << step << " op " << op << std::endl;       \
+            std::exit(1);                                                                          \
+        }                                                                                          \
+    } while (0)
+
+template <typename T>
+T makeValue(size_t n);
+
+template <>
+int makeValue<int>(size_t n) {
+    return static_cast<int>(n);
+}
+
+template <>
+std::string makeValue<std::string>(size_t n) {
+    return "value-" + std::to_string(n) + "-with-a-payload-past-the-small-string-buffer";
+}
+
+/**************************************************************************************************
+ * @brief Compares every observable view of the two containers.
+ **************************************************************************************************/
+template <typename D, typename T>
+bool sameContents(D& d, const std::deque<T>& r) {
+    if (d.size() != r.size() || d.empty() != r.empty()) {
+        return false;
+    }
+    if (!r.empty() && (d.front() != r.front() || d.back() != r.back())) {
+        return false;
+    }
+
+    size_t i = 0;
+    for (auto it = d.begin(); it != d.end(); ++it, ++i) {
+        if (*it != r[i] || d[i] != r[i]) {
+            return false;
+        }
+    }
+    for (auto it = d.cend(); it != d.cbegin();) {
+        if (*--it != r[--i]) {
+            return false;
+        }
+    }
+    if (d.end() - d.begin() != static_cast<std::ptrdiff_t>(r.size())) {
+        return false;
+    }
+
+    i = 0;
+    bool same = true;
+    d.for_each_segment([&](auto segment) {
+        for (const T& value : segment) {
+            same = same && i < r.size() && value == r[i++];
+        }
+    });
+    if (!same || i != r.size()) {
+        return false;
+    }
+
+    std::vector<T> flat(r.size());
+    return d.copy_out(flat.data()) == flat.data() + flat.size() &&
+           std::equal(flat.begin(), flat.end(), r.begin());
+}
+
+/**************************************************************************************************
+ * @brief Replays one random operation stream and checks both containers after each step.
+ * 
+ * Long runs of pushes at one end are mixed in on purpose: they exercise growMap() repeatedly
+ * while the other end still holds elements.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+void runStream(unsigned seed, size_t steps) {
+    std::mt19937 rng(seed);
+    Deque<T, BLOCK_SIZE> d(rng() % 6);
+    std::deque<T> r;
+    size_t counter = 0;
+    int op = -1;
+
+    d.set_spare_block_limit(rng() % 4);
+
+    for (size_t step = 0; step < steps; ++step) {
+        op = static_cast<int>(rng() % 22);
+        switch (op) {
+        case 0: case 1: case 2: {
+            T value = makeValue<T>(counter++);
+            d.push_back(value);
+            r.push_back(value);
+            break;
+        }
+        case 3: case 4: {
+            T value = makeValue<T>(counter++);
+            d.push_front(std::move(value));
+            r.push_front(makeValue<T>(counter - 1));
+            break;
+        }
+        case 5: {
+            d.emplace_back(makeValue<T>(counter));
+            r.emplace_back(makeValue<T>(counter++));
+            break;
+        }
+        case 6: case 7:
+            if (!r.empty()) {
+                d.pop_front();
+                r.pop_front();
+            }
+            break;
+        case 8: case 9:
+            if (!r.empty()) {
+                d.pop_back();
+                r.pop_back();
+            }
+            break;
+        case 10: {
+            size_t run = rng() % (8 * BLOCK_SIZE + 8);
+            bool back = rng() % 2;
+            for (size_t i = 0; i < run; ++i) {
+                T value = makeValue<T>(counter++);
+                if (back) {
+                    d.push_back(value);
+                    r.push_back(value);
+                } else {
+                    d.push_front(value);
+                    r.push_front(value);
+                }
+            }
+            break;
+        }
+        case 11: {
+            std::vector<T> batch;
+            for (size_t i = rng() % (3 * BLOCK_SIZE + 2); i > 0; --i) {
+                batch.push_back(makeValue<T>(counter++));
+            }
+            d.append_range(batch);
+            r.insert(r.end(), batch.begin(), batch.end());
+            break;
+        }
+        case 12: {
+            std::list<T> batch;
+            for (size_t i = rng() % (3 * BLOCK_SIZE + 2); i > 0; --i) {
+                batch.push_back(makeValue<T>(counter++));
+            }
+            d.prepend_range(batch);
+            r.insert(r.begin(), batch.begin(), batch.end());
+            break;
+        }
+        case 13:
+            if (!r.empty()) {
+                size_t index = rng() % r.size();
+                CHECK(d.at(index) == r[index]);
+                auto it = d.begin() + static_cast<std::ptrdiff_t>(index);
+                CHECK(*it == r[index]);
+                size_t other = rng() % r.size();
+                it -= static_cast<std::ptrdiff_t>(index) - static_cast<std::ptrdiff_t>(other);
+                CHECK(*it == r[other]);
+            }
+            break;
+        case 14:
+            if (rng() % 8 == 0) {
+                d.clear();
+                r.clear();
+            }
+            break;
+        case 15:
+            if (rng() % 4 == 0) {
+                d.shrink_to_fit();
+            }
+            break;
+        case 16: {
+            Deque<T, BLOCK_SIZE> copy(d);
+            CHECK(sameContents(copy, r));
+            Deque<T, BLOCK_SIZE> moved(std::move(copy));
+            CHECK(copy.empty());
+            d = moved;
+            break;
+        }
+        case 17: {
+            Deque<T, BLOCK_SIZE> other;
+            other = std::move(d);
+            d = std::move(other);
+            break;
+        }
+        case 18:
+            if (rng() % 16 == 0) {
+                std::vector<T> batch;
+                for (size_t i = rng() % (2 * BLOCK_SIZE + 1); i > 0; --i) {
+                    batch.push_back(makeValue<T>(counter++));
+                }
+                d.assign(batch);
+                r.assign(batch.begin(), batch.end());
+            }
+            break;
+        case 19:
+            d.set_spare_block_limit(rng() % 4);
+            break;
+        case 20:
+            d.reserve_back(rng() % (4 * BLOCK_SIZE + 4));
+            break;
+        case 21:
+            d.reserve_front(rng() % (4 * BLOCK_SIZE + 4));
+            break;
+        }
+        CHECK(sameContents(d, r));
+    }
+}
+
+/**************************************************************************************************
+ * @brief Expects a call to throw std::runtime_error.
+ **************************************************************************************************/
+template <typename F>
+bool throwsRuntimeError(F&& f) {
+    try {
+        f();
+    } catch (const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+static size_t blockAllocations = 0;
+static size_t liveAllocations = 0;
+static size_t failingAllocation = 0;
+
+/**************************************************************************************************
+ * @brief Allocator that counts every allocation the deque makes for blocks and the map.
+ *
+ * Throws std::bad_alloc from the allocation numbered failingAllocation, unless that is zero.
+ **************************************************************************************************/
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        if (++blockAllocations == failingAllocation) {
+            throw std::bad_alloc();
+        }
+        ++liveAllocations;
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, size_t n) {
+        --liveAllocations;
+        std::allocator<T>().deallocate(p, n);
+    }
+    bool operator==(const CountingAllocator&) const { return true; }
+};
+
+/**************************************************************************************************
+ * @brief Checks that reserve_back()/reserve_front() make the following pushes allocation-free.
+ *
+ * Also checks that a queue holding a steady depth settles into a fixed map instead of growing
+ * it on every wrap.
+ **************************************************************************************************/
+template <size_t BLOCK_SIZE>
+void checkReservations(unsigned seed) {
+    std::mt19937 rng(seed);
+    size_t step = 0;
+    int op = -1;
+
+    Deque<int, BLOCK_SIZE, CountingAllocator<int>> d(rng() % (4 * BLOCK_SIZE));
+    std::deque<int> r;
+    for (step = 0; step < 200; ++step) {
+        op = static_cast<int>(rng() % 3);
+        size_t n = rng() % (6 * BLOCK_SIZE + 2);
+        if (op == 0) {
+            d.reserve_back(n);
+            size_t before = blockAllocations;
+            for (size_t i = 0; i < n; ++i) {
+                d.push_back(static_cast<int>(i));
+                r.push_back(static_cast<int>(i));
+            }
+            CHECK(blockAllocations == before);
+        } else if (op == 1) {
+            d.reserve_front(n);
+            d.reserve_back(n / 2);
+            size_t before = blockAllocations;
+            for (size_t i = 0; i < n; ++i) {
+                d.push_front(static_cast<int>(i));
+                r.push_front(static_cast<int>(i));
+            }
+            for (size_t i = 0; i < n / 2; ++i) {
+                d.push_back(static_cast<int>(i));
+                r.push_back(static_cast<int>(i));
+            }
+            CHECK(blockAllocations == before);
+        } else {
+            for (size_t i = 0; i < n && !r.empty(); ++i) {
+                d.pop_front();
+                r.pop_front();
+            }
+        }
+        CHECK(sameContents(d, r));
+    }
+
+    Deque<int, BLOCK_SIZE, CountingAllocator<int>> queue;
+    for (int i = 0; i < 64; ++i) {
+        queue.push_back(i);
+    }
+    for (int i = 0; i < 1000; ++i) {
+        queue.push_back(i);
+        queue.pop_front();
+    }
+    size_t before = blockAllocations;
+    for (step = 0; step < 100000; ++step) {
+        queue.push_back(static_cast<int>(step));
+        queue.pop_front();
+    }
+    CHECK(blockAllocations == before);
+}
+
+/**************************************************************************************************
+ * @brief Checks that a prepend_range() whose allocations fail leaves the deque unchanged.
+ *
+ * Covers sized ranges and input-only ranges. After the failure, the contents, the front
+ * reservation and the allocator balance must be as before the call.
+ **************************************************************************************************/
+template <size_t BLOCK_SIZE>
+void checkFailedPrepends(unsigned seed) {
+    std::mt19937 rng(seed);
+    size_t step = 0;
+    int op = -1;
+
+    size_t live = liveAllocations;
+    {
+        Deque<int, BLOCK_SIZE, CountingAllocator<int>> d;
+        d.set_spare_block_limit(64);
+        std::deque<int> r;
+        for (step = 0; step < 100; ++step) {
+            op = static_cast<int>(rng() % 2);
+            size_t n = rng() % (6 * BLOCK_SIZE + 2);
+            for (size_t i = 0; i < n; ++i) {
+                d.push_back(static_cast<int>(i));
+                r.push_back(static_cast<int>(i));
+            }
+            size_t reserved = rng() % (2 * BLOCK_SIZE + 1);
+            d.reserve_front(reserved);
+
+            std::vector<int> batch(rng() % (8 * BLOCK_SIZE + 2), static_cast<int>(step));
+            std::string text;
+            for (int value : batch) {
+                text += std::to_string(value) + ' ';
+            }
+            std::istringstream stream(text);
+            failingAllocation = blockAllocations + 1 + rng() % 4;
+            bool failed = false;
+            try {
+                if (op == 0) {
+                    d.prepend_range(batch);
+                } else {
+                    d.prepend_range(std::views::istream<int>(stream));
+                }
+            } catch (const std::bad_alloc&) {
+                failed = true;
+            }
+            failingAllocation = 0;
+            if (!failed) {
+                r.insert(r.begin(), batch.begin(), batch.end());
+                continue;
+            }
+            CHECK(sameContents(d, r));
+
+            size_t before = blockAllocations;
+            for (size_t i = 0; i < reserved; ++i) {
+                d.push_front(-1);
+                r.push_front(-1);
+            }
+            CHECK(blockAllocations == before);
+            CHECK(sameContents(d, r));
+        }
+        for (size_t i = 0; i < 4 * BLOCK_SIZE; ++i) {
+            d.push_back(0);
+        }
+    }
+    CHECK(liveAllocations == live);
+}
+
+/**************************************************************************************************
+ * @brief Checks that clear() never allocates, so a failing allocator cannot break it.
+ *
+ * Runs with an empty spare block cache and with outstanding front reservations, the cases
+ * in which a freshly allocated block could not come from the cache.
+ **************************************************************************************************/
+template <size_t BLOCK_SIZE>
+void checkClear(unsigned seed) {
+    std::mt19937 rng(seed);
+    size_t step = 0;
+    int op = -1;
+
+    size_t live = liveAllocations;
+    {
+        Deque<int, BLOCK_SIZE, CountingAllocator<int>> d;
+        d.set_spare_block_limit(0);
+        std::deque<int> r;
+        for (step = 0; step < 50; ++step) {
+            op = static_cast<int>(rng() % 2);
+            for (size_t i = rng() % (6 * BLOCK_SIZE + 2); i > 0; --i) {
+                d.push_back(static_cast<int>(i));
+            }
+            if (op == 1) {
+                d.reserve_front(rng() % (2 * BLOCK_SIZE + 1));
+            }
+            size_t before = blockAllocations;
+            failingAllocation = blockAllocations + 1;
+            d.clear();
+            d.clear();
+            failingAllocation = 0;
+            CHECK(blockAllocations == before);
+            CHECK(sameContents(d, r));
+            d.push_back(static_cast<int>(step));
+            d.push_front(static_cast<int>(step));
+            CHECK(d.size() == 2 && d.front() == d.back());
+        }
+    }
+    CHECK(liveAllocations == live);
+}
+
+/**************************************************************************************************
+ * @brief Element whose copy constructor throws once a given number of copies has been made.
+ *
+ * Counts live objects so that copies left behind by a failed operation can be detected.
+ **************************************************************************************************/
+struct ThrowingCopy {
+    static inline size_t live = 0;
+    static inline size_t copiesUntilFailure = 0;
+
+    int value;
+
+    ThrowingCopy(int v) : value(v) { ++live; }
+    ThrowingCopy(const ThrowingCopy& other) : value(other.value) {
+        if (copiesUntilFailure && --copiesUntilFailure == 0) {
+            throw std::runtime_error("ThrowingCopy copy failed.\n");
+        }
+        ++live;
+    }
+    ~ThrowingCopy() { --live; }
+};
+
+/**************************************************************************************************
+ * @brief Checks that constructors which fail part way leave nothing behind.
+ *
+ * A copy constructor whose element copy throws must destroy the copies it made and release
+ * all storage. A sized
+ * constructor whose reservation fails must release the map and blocks it allocated.
+ **************************************************************************************************/
+template <size_t BLOCK_SIZE>
+void checkFailedConstruction(unsigned seed) {
+    std::mt19937 rng(seed);
+    size_t step = 0;
+    int op = -1;
+
+    size_t live = liveAllocations;
+    for (step = 0; step < 20; ++step) {
+        op = 1;
+        size_t n = rng() % (16 * BLOCK_SIZE + 1);
+        failingAllocation = blockAllocations + 1 + rng() % 4;
+        try {
+            Deque<int, BLOCK_SIZE, CountingAllocator<int>> d(n);
+        } catch (const std::bad_alloc&) {
+        }
+        failingAllocation = 0;
+        CHECK(liveAllocations == live);
+
+        op = 0;
+        {
+            Deque<ThrowingCopy, BLOCK_SIZE, CountingAllocator<ThrowingCopy>> source;
+            for (size_t i = rng() % (6 * BLOCK_SIZE + 2); i > 0; --i) {
+                source.emplace_back(static_cast<int>(i));
+            }
+            size_t objects = ThrowingCopy::live;
+            ThrowingCopy::copiesUntilFailure = 1 + rng() % (source.size() + 1);
+            bool thrown = false;
+            try {
+                Deque<ThrowingCopy, BLOCK_SIZE, CountingAllocator<ThrowingCopy>> copy(source);
+                CHECK(copy.size() == source.size());
+            } catch (const std::runtime_error&) {
+                thrown = true;
+            }
+            CHECK(thrown == (ThrowingCopy::copiesUntilFailure == 0));
+            ThrowingCopy::copiesUntilFailure = 0;
+            CHECK(ThrowingCopy::live == objects);
+        }
+        CHECK(ThrowingCopy::live == 0);
+        CHECK(liveAllocations == live);
+    }
+}
+
+/**************************************************************************************************
+ * @brief Checks that moves allocate nothing and leave a source that is still fully usable.
+ **************************************************************************************************/
+template <size_t BLOCK_SIZE>
+void checkMoves(unsigned seed) {
+    using CountingDeque = Deque<int, BLOCK_SIZE, CountingAllocator<int>>;
+    static_assert(std::is_nothrow_move_constructible_v<Deque<int, BLOCK_SIZE>>);
+    static_assert(std::is_nothrow_move_assignable_v<Deque<int, BLOCK_SIZE>>);
+    static_assert(std::is_nothrow_move_constructible_v<CountingDeque>);
+    static_assert(std::is_nothrow_move_assignable_v<CountingDeque>);
+
+    std::mt19937 rng(seed);
+    size_t step = 0;
+    int op = -1;
+
+    CountingDeque d;
+    std::deque<int> r;
+    for (step = 0; step < 50; ++step) {
+        op = static_cast<int>(rng() % 8);
+        size_t n = rng() % (3 * BLOCK_SIZE + 2);
+        std::vector<int> batch(n, static_cast<int>(step));
+        if (op == 0) {
+            d.push_back(static_cast<int>(step));
+            r.push_back(static_cast<int>(step));
+        } else if (op == 1) {
+            d.push_front(static_cast<int>(step));
+            r.push_front(static_cast<int>(step));
+        } else if (op == 2) {
+            d.append_range(batch);
+            r.insert(r.end(), batch.begin(), batch.end());
+        } else if (op == 3) {
+            d.prepend_range(batch);
+            r.insert(r.begin(), batch.begin(), batch.end());
+        } else if (op == 4) {
+            d.reserve_front(n);
+        } else if (op == 5) {
+            d.reserve_back(n);
+        }
+
+        size_t before = blockAllocations;
+        CountingDeque moved(std::move(d));
+        CHECK(blockAllocations == before);
+        CHECK(d.empty() && d.size() == 0 && d.begin() == d.end() && d.cbegin() == d.cend());
+        CHECK(d.stats().blocksInUse == 0 && d.stats().mapSlots == 0 && d.spare_blocks() == 0);
+        d.clear();
+        d.shrink_to_fit();
+        d.set_spare_block_limit(rng() % 4);
+        CountingDeque empty(d);
+        CHECK(empty.empty());
+        CHECK(throwsRuntimeError([&] { d.pop_front(); }));
+        CHECK(throwsRuntimeError([&] { (void)d.back(); }));
+        CHECK(sameContents(moved, r));
+
+        CountingDeque target(BLOCK_SIZE);
+        target.push_back(-1);
+        before = blockAllocations;
+        target = std::move(moved);
+        CHECK(blockAllocations == before);
+        CHECK(moved.empty() && moved.begin() == moved.end());
+        CHECK(sameContents(target, r));
+
+        if (rng() % 2) {
+            moved = std::move(target);
+            d = std::move(moved);
+        } else {
+            d = std::move(target);
+        }
+        CHECK(sameContents(d, r));
+    }
+}
+
+/**************************************************************************************************
+ * @brief Checks the DequeStats policy against the allocator and a reference peak.
+ * 
+ * Blocks requested from the allocator minus blocks returned must equal the blocks in use
+ * plus the cached ones, the peaks must match the largest size seen, and the growth hook
+ * must fire once per map growth. Both must still hold after a successful and a failed load().
+ **************************************************************************************************/
+template <size_t BLOCK_SIZE>
+void checkStats(unsigned seed) {
+    static_assert(std::is_empty_v<NoDequeStats>);
+    static_assert(sizeof(Deque<int, BLOCK_SIZE>) < sizeof(Deque<int, BLOCK_SIZE, std::allocator<int>, DequeStats>));
+
+    std::mt19937 rng(seed);
+    size_t step = 0;
+    int op = -1;
+
+    Deque<int, BLOCK_SIZE, std::allocator<int>, DequeStats> d;
+    std::deque<int> r;
+    size_t growthEvents = 0;
+    d.stats_policy().set_growth_hook([&](std::chrono::nanoseconds elapsed, bool) {
+        ++growthEvents;
+        CHECK(elapsed.count() >= 0);
+    });
+
+    size_t peakSize = 0;
+    for (step = 0; step < 400; ++step) {
+        op = static_cast<int>(rng() % 5);
+        size_t n = rng() % (4 * BLOCK_SIZE + 2);
+        for (size_t i = 0; i < n; ++i) {
+            if (op == 0) {
+                d.push_back(static_cast<int>(i));
+                r.push_back(static_cast<int>(i));
+            } else if (op == 1) {
+                d.push_front(static_cast<int>(i));
+                r.push_front(static_cast<int>(i));
+            } else if (!r.empty() && op == 2) {
+                d.pop_front();
+                r.pop_front();
+            } else if (!r.empty()) {
+                d.pop_back();
+                r.pop_back();
+            }
+        }
+        peakSize = std::max(peakSize, r.size());
+
+        DequeStatsSnapshot stats = d.stats();
+        CHECK(stats.size == r.size());
+        CHECK(stats.peakSize == peakSize);
+        CHECK(stats.peakBlocks >= stats.blocksInUse);
+        CHECK(stats.allocatorAllocations - stats.allocatorDeallocations == stats.blocksInUse + stats.spareBlocks);
+        CHECK(stats.mapGrowths + stats.mapRecenters == growthEvents);
+        CHECK(stats.mapOccupancy() > 0.0 && stats.mapOccupancy() <= 1.0);
+    }
+    CHECK(d.stats().bytesCopied > 0);
+
+    op = 5;
+    std::filesystem::path path = std::filesystem::temp_directory_path() /
+                                 ("dequeStats-" + std::to_string(::getpid()) + "-" + std::to_string(BLOCK_SIZE));
+    Deque<int, BLOCK_SIZE> source;
+    for (size_t i = 0; i < 6 * BLOCK_SIZE + 3; ++i) {
+        source.push_back(static_cast<int>(i));
+    }
+    source.save(path);
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        if (attempt == 1) {
+            std::filesystem::resize_file(path, std::filesystem::file_size(path) - sizeof(int));
+            CHECK(throwsRuntimeError([&] { d.load(path); }));
+        } else {
+            d.load(path);
+            r.assign(source.begin(), source.end());
+        }
+        CHECK(sameContents(d, r));
+        DequeStatsSnapshot loaded = d.stats();
+        CHECK(loaded.allocatorAllocations - loaded.allocatorDeallocations == loaded.blocksInUse + loaded.spareBlocks);
+        CHECK(loaded.mapGrowths + loaded.mapRecenters == growthEvents);
+        CHECK(loaded.peakSize >= r.size() && loaded.peakBlocks >= loaded.blocksInUse);
+    }
+    std::filesystem::remove(path);
+    d.clear();
+    d.shrink_to_fit();
+    r.clear();
+    DequeStatsSnapshot cleared = d.stats();
+    CHECK(cleared.allocatorAllocations - cleared.allocatorDeallocations == cleared.blocksInUse + cleared.spareBlocks);
+
+    d.reset_stats();
+    DequeStatsSnapshot stats = d.stats();
+    CHECK(stats.blockAllocations == 0 && stats.mapGrowths == 0 && stats.bytesCopied == 0);
+    CHECK(stats.peakSize == r.size());
+
+    Deque<int, BLOCK_SIZE> plain;
+    plain.push_back(1);
+    CHECK(plain.stats().blockAllocations == 0 && plain.stats().size == 1);
+}
+
+/**************************************************************************************************
+ * @brief Checks the parallel algorithms and the iterators they rely on against std algorithms.
+ * 
+ * Runs each algorithm on a pool with several workers and on a pool that runs everything on
+ * the calling thread, over deques whose front and back blocks are only partly filled.
+ **************************************************************************************************/
+template <typename T, size_t BLOCK_SIZE>
+void checkParallel(unsigned seed, DequeThreadPool& pool) {
+    static_assert(std::random_access_iterator<typename Deque<T, BLOCK_SIZE>::iterator>);
+    static_assert(std::random_access_iterator<typename Deque<T, BLOCK_SIZE>::const_iterator>);
+
+    std::mt19937 rng(seed);
+    size_t step = 0;
+    int op = -1;
+
+    for (step = 0; step < 6; ++step) {
+        Deque<T, BLOCK_SIZE> d;
+        std::deque<T> r;
+        size_t n = rng() % (64 * BLOCK_SIZE + 64);
+        for (size_t i = 0; i < n; ++i) {
+            T value = makeValue<T>(rng() % 1000);
+            if (rng() % 3) {
+                d.push_back(value);
+                r.push_back(value);
+            } else {
+                d.push_front(value);
+                r.push_front(value);
+            }
+        }
+
+        op = 0;
+        parallel_for_each(d, [](T& value) { value = value + value; }, pool);
+        for (T& value : r) {
+            value = value + value;
+        }
+        CHECK(sameContents(d, r));
+
+        op = 1;
+        std::vector<T> out(r.size());
+        CHECK(parallel_transform(d, out.begin(), [](const T& value) { return value + value; }, pool) == out.end());
+        std::transform(r.begin(), r.end(), r.begin(), [](const T& value) { return value + value; });
+        CHECK(std::equal(out.begin(), out.end(), r.begin()));
+        parallel_transform(d, d.begin(), [](const T& value) { return value + value; }, pool);
+        CHECK(sameContents(d, r));
+
+        op = 2;
+        T init = makeValue<T>(7);
+        CHECK(parallel_reduce(d, init, std::plus<>(), pool) == std::accumulate(r.begin(), r.end(), init));
+
+        op = 3;
+        if (!r.empty()) {
+            T target = r[rng() % r.size()];
+            auto match = [&](const T& value) { return value == target; };
+            CHECK(parallel_find_if(d, match, pool) - d.begin() == std::find_if(r.begin(), r.end(), match) - r.begin());
+        }
+        CHECK(parallel_find_if(d, [](const T&) { return false; }, pool) == d.end());
+
+        op = 4;
+        parallel_sort(d, std::less<>(), pool);
+        std::sort(r.begin(), r.end());
+        CHECK(sameContents(d, r));
+        parallel_sort(d, std::greater<>(), pool);
+        std::sort(r.begin(), r.end(), std::greater<>());
+        CHECK(sameContents(d, r));
+    }
+
+    op = 5;
+    Deque<T, BLOCK_SIZE> d(4 * BLOCK_SIZE);
+    for (size_t i = 0; i < 4 * BLOCK_SIZE; ++i) {
+        d.push_back(makeValue<T>(i));
+    }
+    bool thrown = false;
+    try {
+        parallel_for_each(d, [](T&) { throw std::runtime_error("task failed"); }, pool);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(d.size() == 4 * BLOCK_SIZE);
+}
+
+/**************************************************************************************************
+ * @brief Checks save()/load() and MappedDeque round trips, and rejection of mismatched snapshots.
+ **************************************************************************************************/
+template <size_t BLOCK_SIZE>
+void checkSnapshots(unsigned seed) {
+    struct Record {
+        int id;
+        double weight;
+        bool operator==(const Record&) const = default;
+    };
+
+    std::mt19937 rng(seed);
+    size_t step = 0;
+    int op = -1;
+    std::filesystem::path path = std::filesystem::temp_directory_path() /
+                                 ("dequeSnapshot-" + std::to_string(::getpid()) + "-" + std::to_string(BLOCK_SIZE));
+
+    for (step = 0; step < 8; ++step) {
+        Deque<int, BLOCK_SIZE> d;
+        std::deque<int> r;
+        for (size_t i = rng() % (8 * BLOCK_SIZE + 8); i > 0; --i) {
+            int value = static_cast<int>(rng());
+            if (rng() % 2) {
+                d.push_back(value);
+                r.push_back(value);
+            } else {
+                d.push_front(value);
+                r.push_front(value);
+            }
+        }
+        for (size_t i = rng() % (r.size() + 1); i > 0; --i) {
+            d.pop_front();
+            r.pop_front();
+        }
+
+        op = 0;
+        d.save(path);
+        Deque<int, BLOCK_SIZE> loaded(3);
+        loaded.push_back(-1);
+        loaded.load(path);
+        CHECK(sameContents(loaded, r));
+        loaded.push_back(1);
+        loaded.push_front(2);
+        r.push_back(1);
+        r.push_front(2);
+        CHECK(sameContents(loaded, r));
+        r.pop_back();
+        r.pop_front();
+
+        op = 1;
+        MappedDeque<int, BLOCK_SIZE> mapped(path);
+        CHECK(mapped.size() == r.size() && mapped.empty() == r.empty());
+        CHECK(std::equal(mapped.begin(), mapped.end(), r.begin(), r.end()));
+        for (size_t i = 0; i < r.size(); ++i) {
+            CHECK(mapped[i] == r[i] && mapped.at(i) == r[i]);
+        }
+        size_t i = 0;
+        bool same = true;
+        mapped.for_each_segment([&](std::span<const int> segment) {
+            same = same && segment.size() <= BLOCK_SIZE;
+            for (int value : segment) {
+                same = same && value == r[i++];
+            }
+        });
+        CHECK(same && i == r.size());
+        CHECK(throwsRuntimeError([&] { (void)mapped.at(r.size()); }));
+        MappedDeque<int, BLOCK_SIZE> moved(std::move(mapped));
+        CHECK(moved.size() == r.size() && mapped.empty());
+
+        op = 2;
+        CHECK(throwsRuntimeError([&] { Deque<int, 2 * BLOCK_SIZE>().load(path); }));
+        CHECK(throwsRuntimeError([&] { Deque<double, BLOCK_SIZE>().load(path); }));
+        CHECK(throwsRuntimeError([&] { Deque<short, BLOCK_SIZE>().load(path); }));
+        CHECK(throwsRuntimeError([&] { MappedDeque<int, BLOCK_SIZE + 1> other(path); }));
+        CHECK(throwsRuntimeError([&] { MappedDeque<long long, BLOCK_SIZE> other(path); }));
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+        CHECK(throwsRuntimeError([&] { loaded.load(path); }));
+        CHECK(throwsRuntimeError([&] { MappedDeque<int, BLOCK_SIZE> other(path); }));
+        CHECK(loaded.size() == r.size() + 2);
+    }
+
+    op = 3;
+    Deque<Record, BLOCK_SIZE> records;
+    for (int i = 0; i < static_cast<int>(3 * BLOCK_SIZE); ++i) {
+        records.push_front(Record{i, i / 2.0});
+    }
+    records.save(path);
+    Deque<Record, BLOCK_SIZE> restored;
+    restored.load(path);
+    MappedDeque<Record, BLOCK_SIZE> view(path);
+    CHECK(std::equal(restored.begin(), restored.end(), records.begin(), records.end()));
+    CHECK(std::equal(view.begin(), view.end(), records.begin(), records.end()));
+    CHECK(view.front() == records.front() && view.back() == records.back());
+
+    std::filesystem::remove(path);
+    CHECK(throwsRuntimeError([&] { MappedDeque<Record, BLOCK_SIZE> missing(path); }));
+}
+
+template <typename T, size_t BLOCK_SIZE>
+void runAll(unsigned seeds, size_t steps) {
+    for (unsigned seed = 1; seed <= seeds; ++seed) {
+        runStream<T, BLOCK_SIZE>(seed, steps);
+    }
+}
+
+int main(int argc, char** argv) {
+    unsigned seeds = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : 20;
+    size_t steps = argc > 2 ? static_cast<size_t>(std::atoll(argv[2])) : 2000;
+
+    runAll<int, 1>(seeds, steps);
+    runAll<int, 3>(seeds, steps);
+    runAll<int, 4>(seeds, steps);
+    runAll<int, DequeBlockSize<int>::value>(seeds, steps);
+    runAll<std::string, 2>(seeds, steps);
+    runAll<std::string, 5>(seeds, steps);
+    runAll<std::string, DequeBlockSize<std::string>::value>(seeds, steps);
+    for (unsigned seed = 1; seed <= seeds; ++seed) {
+        checkReservations<1>(seed);
+        checkReservations<4>(seed);
+        checkReservations<5>(seed);
+        checkReservations<64>(seed);
+        checkFailedPrepends<1>(seed);
+        checkFailedPrepends<4>(seed);
+        checkFailedPrepends<5>(seed);
+        checkClear<1>(seed);
+        checkClear<4>(seed);
+        checkClear<5>(seed);
+        checkFailedConstruction<1>(seed);
+        checkFailedConstruction<4>(seed);
+        checkFailedConstruction<5>(seed);
+        checkMoves<1>(seed);
+        checkMoves<4>(seed);
+        checkMoves<5>(seed);
+        checkStats<1>(seed);
+        checkStats<4>(seed);
+        checkStats<16>(seed);
+    }
+
+    for (unsigned seed = 1; seed <= seeds; ++seed) {
+        checkSnapshots<1>(seed);
+        checkSnapshots<4>(seed);
+        checkSnapshots<5>(seed);
+        checkSnapshots<DequeBlockSize<int>::value>(seed);
+    }
+
+    DequeThreadPool pool(4);
+    DequeThreadPool inlinePool(1);
+    for (unsigned seed = 1; seed <= seeds; ++seed) {
+        checkParallel<int, 1>(seed, pool);
+        checkParallel<int, 3>(seed, pool);
+        checkParallel<int, DequeBlockSize<int>::value>(seed, pool);
+        checkParallel<std::string, 4>(seed, pool);
+        checkParallel<int, 16>(seed, inlinePool);
+    }
+
+    std::cout << "dequeDifferentialTest: all streams match std::deque" << std::endl;
+    return 0;
+}